@@ -19,6 +19,8 @@
 
 #include "breakbase.h"
 #include "breakcontrol.h"
+#include "rsiglobals.h"
+#include "rsitransition.h"
 
 #include <KWindowSystem>
 
@@ -28,11 +30,13 @@
 #include <QObject>
 #include <QPainter>
 #include <QKeyEvent>
+#include <QTimer>
 
 
 BreakBase::BreakBase( QObject* parent )
         : QObject( parent ),  m_grayEffectOnAllScreens( 0 ), m_readOnly( false ),
-        m_disableShortcut( false ), m_grayEffectOnAllScreensActivated( false )
+        m_disableShortcut( false ), m_grayEffectOnAllScreensActivated( false ),
+        m_memoryBudget( -1 )
 {
     m_breakControl = new BreakControl( 0, Qt::Popup );
     m_breakControl->hide();
@@ -40,6 +44,17 @@ BreakBase::BreakBase( QObject* parent )
     connect(m_breakControl, &BreakControl::skip, this, &BreakBase::skip);
     connect(m_breakControl, &BreakControl::lock, this, &BreakBase::lock);
     connect(m_breakControl, &BreakControl::postpone, this, &BreakBase::postpone);
+
+    // Docking a laptop changes the screens a couple of times in a row,
+    // wait until that settles.
+    m_screenTimer = new QTimer( this );
+    m_screenTimer->setSingleShot( true );
+    m_screenTimer->setInterval( 250 );
+    connect( m_screenTimer, &QTimer::timeout, this, &BreakBase::slotScreensChanged );
+
+    QDesktopWidget *desktop = QApplication::desktop();
+    connect( desktop, &QDesktopWidget::screenCountChanged, m_screenTimer, static_cast<void (QTimer::*)()>( &QTimer::start ) );
+    connect( desktop, &QDesktopWidget::resized, m_screenTimer, static_cast<void (QTimer::*)()>( &QTimer::start ) );
 }
 
 BreakBase::~BreakBase()
@@ -53,18 +68,31 @@ void BreakBase::activate()
     if ( m_grayEffectOnAllScreensActivated )
         m_grayEffectOnAllScreens->activate();
 
+    // Does nothing when the break was prepared in time.
+    prepare();
+
     m_breakControl->show();
     m_breakControl->setFocus();
 
-    KWindowSystem::forceActiveWindow( m_breakControl->winId() );
-    KWindowSystem::setOnAllDesktops( m_breakControl->winId(), true );
-    KWindowSystem::setState( m_breakControl->winId(), NET::KeepAbove );
-    KWindowSystem::setState( m_breakControl->winId(), NET::FullScreen );
+    setupWindow( m_breakControl );
 
     m_breakControl->grabKeyboard();
     m_breakControl->grabMouse();
 }
 
+void BreakBase::prepare()
+{
+    if ( m_grayEffectOnAllScreensActivated )
+        m_grayEffectOnAllScreens->prepare();
+
+    // The window manager forgets the state of a hidden window, that is set
+    // again when it is shown.
+    if ( !m_breakControl->testAttribute( Qt::WA_WState_Created ) ) {
+        m_breakControl->ensurePolished();
+        m_breakControl->winId();
+    }
+}
+
 void BreakBase::deactivate()
 {
     if ( m_grayEffectOnAllScreensActivated )
@@ -134,10 +162,12 @@ void BreakBase::disableShortcut( bool disable )
 void BreakBase::setGrayEffectOnAllScreens( bool on )
 {
     m_grayEffectOnAllScreensActivated = on;
-    delete m_grayEffectOnAllScreens;
-    if ( on ) {
+    if ( on && !m_grayEffectOnAllScreens ) {
         m_grayEffectOnAllScreens = new GrayEffectOnAllScreens();
         m_grayEffectOnAllScreens->setLevel( 70 );
+    } else if ( !on ) {
+        delete m_grayEffectOnAllScreens;
+        m_grayEffectOnAllScreens = 0;
     }
 }
 
@@ -151,26 +181,95 @@ void BreakBase::excludeGrayEffectOnScreen( int screen )
     m_grayEffectOnAllScreens->disable( screen );
 }
 
+void BreakBase::setGrayEffectExcludedScreens( const QSet<int> &screens )
+{
+    m_grayEffectOnAllScreens->setExcluded( screens );
+}
 
-// ------------------------ GrayEffectOnAllScreens -------------//
+void BreakBase::slotScreensChanged()
+{
+    screensChanged();
+}
 
-GrayEffectOnAllScreens::GrayEffectOnAllScreens()
+void BreakBase::screensChanged()
 {
-    for ( int i = 0; i < QApplication::desktop()->numScreens(); ++i ) {
-        GrayWidget* grayWidget = new GrayWidget( 0 );
-        m_widgets.insert( i, grayWidget );
+    if ( m_grayEffectOnAllScreens )
+        m_grayEffectOnAllScreens->updateScreens();
+}
 
-        QRect rect = QApplication::desktop()->screenGeometry( i );
-        grayWidget->move( rect.topLeft() );
-        grayWidget->setGeometry( rect );
+void BreakBase::setupWindow( QWidget *window )
+{
+    KWindowSystem::forceActiveWindow( window->winId() );
+    KWindowSystem::setOnAllDesktops( window->winId(), true );
+    KWindowSystem::setState( window->winId(), NET::KeepAbove );
+    KWindowSystem::setState( window->winId(), NET::FullScreen );
+}
 
-        KWindowSystem::forceActiveWindow( grayWidget->winId() );
-        KWindowSystem::setState( grayWidget->winId(), NET::KeepAbove );
-        KWindowSystem::setOnAllDesktops( grayWidget->winId(), true );
-        KWindowSystem::setState( grayWidget->winId(), NET::FullScreen );
+qint64 BreakBase::windowMemory( const QWidget *window )
+{
+    // Hidden windows keep their backing store until they are destroyed.
+    if ( !window->testAttribute( Qt::WA_WState_Created ) )
+        return 0;
 
-        qDebug() << "Created widget for screen" << i << "Position:" << rect.topLeft();
-    }
+    const int ratio = window->devicePixelRatio();
+    return qint64( window->width() * ratio ) * window->height() * ratio * 4;
+}
+
+void BreakBase::reportMemory( QMap<QString, qint64> &report ) const
+{
+    report.insert( "breakControl", windowMemory( m_breakControl ) );
+    if ( m_grayEffectOnAllScreens )
+        report.insert( "grayWindows", m_grayEffectOnAllScreens->memoryUsage() );
+}
+
+qint64 BreakBase::memoryUsage() const
+{
+    QMap<QString, qint64> report;
+    reportMemory( report );
+
+    qint64 total = 0;
+    foreach( qint64 bytes, report )
+        total += bytes;
+    return total;
+}
+
+void BreakBase::setMemoryBudget( qint64 bytes )
+{
+    m_memoryBudget = bytes;
+}
+
+qint64 BreakBase::memoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+void BreakBase::trimMemory()
+{
+    if ( m_memoryBudget < 0 || memoryUsage() <= m_memoryBudget )
+        return;
+
+    qDebug() << "Releasing" << memoryUsage() << "bytes, the budget is" << m_memoryBudget;
+    releaseResources();
+}
+
+void BreakBase::retire()
+{
+}
+
+void BreakBase::releaseResources()
+{
+    m_breakControl->release();
+    if ( m_grayEffectOnAllScreens )
+        m_grayEffectOnAllScreens->release();
+}
+
+
+// ------------------------ GrayEffectOnAllScreens -------------//
+
+GrayEffectOnAllScreens::GrayEffectOnAllScreens()
+        : m_level( 0 ), m_active( false )
+{
+    updateScreens();
 }
 
 GrayEffectOnAllScreens::~GrayEffectOnAllScreens()
@@ -178,8 +277,54 @@ GrayEffectOnAllScreens::~GrayEffectOnAllScreens()
     qDeleteAll( m_widgets.values() );
 }
 
+GrayWidget* GrayEffectOnAllScreens::createWidget( int screen )
+{
+    GrayWidget* grayWidget = new GrayWidget( 0 );
+    m_widgets.insert( screen, grayWidget );
+
+    QRect rect = QApplication::desktop()->screenGeometry( screen );
+    grayWidget->setGeometry( rect );
+    grayWidget->setLevel( m_level );
+    BreakBase::setupWindow( grayWidget );
+
+    qDebug() << "Created widget for screen" << screen << "Position:" << rect.topLeft();
+    return grayWidget;
+}
+
+void GrayEffectOnAllScreens::updateScreens()
+{
+    QDesktopWidget *desktop = QApplication::desktop();
+    const int count = desktop->screenCount();
+
+    foreach( int screen, m_widgets.keys() ) {
+        if ( screen >= count || m_excluded.contains( screen ) ) {
+            qDebug() << "Removing widget from screen" << screen;
+            delete m_widgets.take( screen );
+        }
+    }
+
+    for ( int i = 0; i < count; ++i ) {
+        if ( m_excluded.contains( i ) )
+            continue;
+
+        GrayWidget *widget = m_widgets.value( i );
+        if ( !widget ) {
+            widget = createWidget( i );
+            if ( m_active )
+                widget->show();
+            continue;
+        }
+
+        const QRect rect = desktop->screenGeometry( i );
+        if ( widget->geometry() != rect )
+            widget->setGeometry( rect );
+    }
+}
+
 void GrayEffectOnAllScreens::disable( int screen )
 {
+    m_excluded.insert( screen );
+
     qDebug() << "Removing widget from screen" << screen;
     if ( !m_widgets.contains( screen ) )
         return;
@@ -188,23 +333,56 @@ void GrayEffectOnAllScreens::disable( int screen )
     m_widgets.remove( screen );
 }
 
+void GrayEffectOnAllScreens::setExcluded( const QSet<int> &screens )
+{
+    m_excluded = screens;
+    updateScreens();
+}
+
+void GrayEffectOnAllScreens::prepare()
+{
+    // The windows were released after the last break.
+    foreach( GrayWidget* widget, m_widgets ) {
+        if ( !widget->testAttribute( Qt::WA_WState_Created ) )
+            BreakBase::setupWindow( widget );
+    }
+}
+
 void GrayEffectOnAllScreens::activate()
 {
+    m_active = true;
+    prepare();
     foreach( GrayWidget* widget, m_widgets ) {
-        widget->show();
+        widget->fadeIn();
         widget->update();
     }
 }
 
 void GrayEffectOnAllScreens::deactivate()
 {
+    m_active = false;
     foreach( GrayWidget* widget, m_widgets ) {
-        widget->hide();
+        widget->fadeOut();
     }
 }
 
+void GrayEffectOnAllScreens::release()
+{
+    foreach( GrayWidget* widget, m_widgets )
+        widget->release();
+}
+
+qint64 GrayEffectOnAllScreens::memoryUsage() const
+{
+    qint64 bytes = 0;
+    foreach( GrayWidget* widget, m_widgets )
+        bytes += BreakBase::windowMemory( widget );
+    return bytes;
+}
+
 void GrayEffectOnAllScreens::setLevel( int val )
 {
+    m_level = val;
     foreach( GrayWidget* widget, m_widgets ) {
         widget->setLevel( val );
     }
@@ -214,10 +392,18 @@ void GrayEffectOnAllScreens::setLevel( int val )
 //-------------------- GrayWidget ----------------------------//
 
 
+// The gray windows come and go in a quarter of a second.
+static const int fadeDuration = 250;
+
 GrayWidget::GrayWidget( QWidget *parent )
-        : QWidget( parent, Qt::Popup )
+        : QWidget( parent, Qt::Popup ), m_level( 0 ), m_fadeFrom( 0 ), m_fadeTo( 0 ),
+          m_fadingOut( false ), m_releasePending( false ), m_painted( false )
 {
     setAutoFillBackground( false );
+
+    m_fade = new RSITransition( this );
+    connect( m_fade, &RSITransition::frame, this, &GrayWidget::slotFadeFrame );
+    connect( m_fade, &RSITransition::finished, this, &GrayWidget::slotFadeFinished );
 }
 
 bool GrayWidget::event( QEvent *event )
@@ -227,10 +413,31 @@ bool GrayWidget::event( QEvent *event )
         QPainter p( this );
         p.setCompositionMode( QPainter::CompositionMode_Source );
         p.fillRect( rect(), QColor( 0,0,0,180 ) );
+
+        // While fading in from transparent, the break is seen with the
+        // first frame of the fade instead.
+        m_painted = true;
+        if ( windowOpacity() > 0 || !m_fade->isRunning() )
+            tracePainted();
     }
     return QWidget::event( event );
 }
 
+void GrayWidget::tracePainted()
+{
+    RSIGlobals::instance()->activationTrace()->painted(
+        QApplication::desktop()->screenNumber( this ) );
+}
+
+void GrayWidget::release()
+{
+    if ( m_fade->isRunning() ) {
+        m_releasePending = true;
+        return;
+    }
+    destroy();
+}
+
 void GrayWidget::setLevel( int val )
 {
     double level = 0;
@@ -238,6 +445,62 @@ void GrayWidget::setLevel( int val )
         level = ( double )val / 100;
 
     qDebug() << "New Value" << level;
+    m_level = level;
+    if ( m_fade->isRunning() ) {
+        if ( !m_fadingOut )
+            m_fadeTo = level;
+        return;
+    }
     setWindowOpacity( level );
     update();
 }
+
+void GrayWidget::fadeIn()
+{
+    m_releasePending = false;
+    if ( !isVisible() )
+        m_painted = false;
+    m_fadeFrom = isVisible() ? windowOpacity() : 0;
+    m_fadeTo = m_level;
+    m_fadingOut = false;
+
+    // The first frame makes it transparent before it is shown.
+    m_fade->start( fadeDuration );
+    show();
+}
+
+void GrayWidget::fadeOut()
+{
+    if ( !isVisible() )
+        return;
+
+    m_fadeFrom = windowOpacity();
+    m_fadeTo = 0;
+    m_fadingOut = true;
+    m_fade->start( fadeDuration );
+}
+
+void GrayWidget::slotFadeFrame( qreal progress )
+{
+    setWindowOpacity( m_fadeFrom + ( m_fadeTo - m_fadeFrom ) * progress );
+    if ( !m_fadingOut && m_painted && windowOpacity() > 0 )
+        tracePainted();
+}
+
+void GrayWidget::slotFadeFinished()
+{
+    if ( !m_fadingOut ) {
+        // Without a level the window stays transparent, it is shown now.
+        if ( m_painted )
+            tracePainted();
+        return;
+    }
+
+    m_fadingOut = false;
+    hide();
+    setWindowOpacity( m_level );
+    if ( m_releasePending ) {
+        m_releasePending = false;
+        destroy();
+    }
+}
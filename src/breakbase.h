@@ -22,11 +22,15 @@
 
 #include <QObject>
 #include <QHash>
+#include <QMap>
+#include <QSet>
 #include <QWidget>
 
 class BreakControl;
 class GrayWidget;
 class GrayEffectOnAllScreens;
+class RSITransition;
+class QTimer;
 
 class BreakBase : public QObject
 {
@@ -37,6 +41,12 @@ public:
     ~BreakBase();
     virtual void activate();
     virtual void deactivate();
+
+    /**
+     * Gets ready for a break which starts soon. The windows are created
+     * while hidden, so activate() mostly has to show them.
+     */
+    virtual void prepare();
     virtual void setLabel( const QString& );
     void setReadOnly( bool );
     bool readOnly() const;
@@ -48,20 +58,74 @@ public:
     void setGrayEffectLevel( int level );
     void excludeGrayEffectOnScreen( int screen );
 
+    /** Leaves only @p screens without the gray effect, the others get it. */
+    void setGrayEffectExcludedScreens( const QSet<int> &screens );
+
+    /**
+     * Adds the memory held by the effect to @p report, in bytes for every
+     * part of it. A window counts with the size of its backing store.
+     */
+    virtual void reportMemory( QMap<QString, qint64> &report ) const;
+
+    /** @returns the memory held by the effect, in bytes. */
+    qint64 memoryUsage() const;
+
+    /**
+     * Sets the memory the effect may keep between breaks to @p bytes. With
+     * a negative budget everything is kept.
+     */
+    void setMemoryBudget( qint64 bytes );
+    qint64 memoryBudget() const;
+
+    /**
+     * Releases the resources of the effect when it holds more than its
+     * budget. Call after deactivate(), they are built again when needed.
+     */
+    void trimMemory();
+
+    /**
+     * Called when another effect is used instead of this one. Stops the
+     * work done in the background, configuring the effect again starts it.
+     */
+    virtual void retire();
+
+    /** Keeps @p window above the others and full screen, on all desktops. */
+    static void setupWindow( QWidget *window );
+
+    /** @returns the memory used by @p window for its backing store. */
+    static qint64 windowMemory( const QWidget *window );
+
 protected:
     bool eventFilter( QObject *obj, QEvent *event ) override;
 
+    /**
+     * Releases all resources which can be built again, like the windows,
+     * which are created again when they are shown.
+     */
+    virtual void releaseResources();
+
+    /**
+     * Called once the screens were added, removed or moved, a burst of
+     * changes results in a single call. Follows them with the gray effect.
+     */
+    virtual void screensChanged();
+
 signals:
     void skip();
     void lock();
     void postpone();
 
+private slots:
+    void slotScreensChanged();
+
 private:
     BreakControl* m_breakControl;
+    QTimer* m_screenTimer;
     GrayEffectOnAllScreens* m_grayEffectOnAllScreens;
     bool m_readOnly;
     bool m_disableShortcut;
     bool m_grayEffectOnAllScreensActivated;
+    qint64 m_memoryBudget;
 };
 
 class GrayEffectOnAllScreens
@@ -73,9 +137,24 @@ public:
     void deactivate();
     void setLevel( int val );
     void disable( int screen );
+    void setExcluded( const QSet<int> &screens );
+    void prepare();
+    void release();
+    qint64 memoryUsage() const;
+
+    /**
+     * Follows the screens of the desktop. Only the widgets of screens which
+     * were added or removed are created or deleted, the others are moved.
+     */
+    void updateScreens();
 
 private:
+    GrayWidget* createWidget( int screen );
+
     QHash<int,GrayWidget*> m_widgets;
+    QSet<int> m_excluded;
+    int m_level;
+    bool m_active;
 };
 
 class GrayWidget : public QWidget
@@ -90,8 +169,36 @@ public:
     explicit GrayWidget( QWidget *parent = 0 );
     void setLevel( int );
 
+    /** Shows the widget and fades it in to its level. */
+    void fadeIn();
+
+    /** Fades the widget out and hides it. */
+    void fadeOut();
+
+    /**
+     * Destroys the window while hidden, it is created again when shown.
+     * A window which is fading out is destroyed once it is hidden.
+     */
+    void release();
+
 protected:
     bool event( QEvent *event ) override;
+
+private slots:
+    void slotFadeFrame( qreal progress );
+    void slotFadeFinished();
+
+private:
+    /** Tells the activation trace that the break can be seen on this screen. */
+    void tracePainted();
+
+    RSITransition *m_fade;
+    qreal m_level;
+    qreal m_fadeFrom;
+    qreal m_fadeTo;
+    bool m_fadingOut;
+    bool m_releasePending;
+    bool m_painted;
 };
 
 #endif // BREAKBASE_H
@@ -18,6 +18,7 @@
 */
 
 #include "breakcontrol.h"
+#include "rsiglobals.h"
 
 #include <QApplication>
 #include <QDesktopWidget>
@@ -108,6 +109,11 @@ void BreakControl::showPostpone( bool show )
     m_postponeButton->setVisible( show );
 }
 
+void BreakControl::release()
+{
+    destroy();
+}
+
 void BreakControl::paintEvent( QPaintEvent *event )
 {
     if ( event->type() == QEvent::Paint ) {
@@ -128,5 +134,8 @@ void BreakControl::paintEvent( QPaintEvent *event )
         QPainter painter( this );
         painter.setPen( pen );
         painter.drawPath( box );
+
+        RSIGlobals::instance()->activationTrace()->painted(
+            QApplication::desktop()->screenNumber( this ) );
     }
 }
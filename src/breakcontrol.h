@@ -37,6 +37,9 @@ public:
     void showLock( bool show );
     void showPostpone(bool arg1);
 
+    /** Destroys the window while hidden, it is created again when shown. */
+    void release();
+
 protected:
     void paintEvent( QPaintEvent *event ) override;
 
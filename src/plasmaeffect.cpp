@@ -17,47 +17,37 @@
 */
 
 #include "plasmaeffect.h"
+#include "rsidbuscall.h"
 
 #include <QApplication>
-#include <QDebug>
 #include <QDesktopWidget>
-#include <QDBusInterface>
 
 PlasmaEffect::PlasmaEffect( QObject* parent )
         : BreakBase( parent )
 {
-    // Make all other screens gray...
-    slotGray();
+    m_dashboard = new RSIDBusCall( "org.kde.plasmashell", "/PlasmaShell", "org.kde.PlasmaShell",
+                                   "setDashboardShown", this );
 
-    connect( QApplication::desktop(), &QDesktopWidget::screenCountChanged, this, &PlasmaEffect::slotGray );
+    // Make all other screens gray...
+    setGrayEffectOnAllScreens( true );
+    screensChanged();
 }
 
-void PlasmaEffect::slotGray()
+void PlasmaEffect::screensChanged()
 {
-    // Make all other screens gray...
-    setGrayEffectOnAllScreens( true );
-    excludeGrayEffectOnScreen( QApplication::desktop()->primaryScreen() );
+    // Make all other screens gray, the primary one might have changed.
+    setGrayEffectExcludedScreens( QSet<int>() << QApplication::desktop()->primaryScreen() );
 }
 
 void PlasmaEffect::activate()
 {
-    QDBusInterface dbus( "org.kde.plasmashell", "/PlasmaShell", "org.kde.PlasmaShell" );
-    QDBusMessage reply = dbus.call( QLatin1String( "setDashboardShown" ), true );
+    // The break is shown right away, even when plasmashell is slow.
+    m_dashboard->call( QVariantList() << true );
     BreakBase::activate();
-
-    if ( reply.type() == QDBusMessage::ErrorMessage ) {
-        qWarning() << reply.errorMessage() << reply.errorName();
-    }
 }
 
 void PlasmaEffect::deactivate()
 {
-    QDBusInterface dbus( "org.kde.plasmashell", "/PlasmaShell", "org.kde.PlasmaShell" );
-    QDBusMessage reply = dbus.call( QLatin1String( "setDashboardShown" ), false );
-
-    if ( reply.type() == QDBusMessage::ErrorMessage ) {
-        qWarning() << reply.errorMessage() << reply.errorName();
-    }
-
+    m_dashboard->call( QVariantList() << false );
     BreakBase::deactivate();
 }
@@ -23,6 +23,8 @@
 
 #include <QObject>
 
+class RSIDBusCall;
+
 class PlasmaEffect : public BreakBase
 {
     Q_OBJECT
@@ -30,12 +32,20 @@ class PlasmaEffect : public BreakBase
 public:
     PlasmaEffect( QObject* );
 
+    /** The call which shows the dashboard, with its statistics. */
+    const RSIDBusCall *dashboardCall() const {
+        return m_dashboard;
+    }
+
 public slots:
     void activate() override;
     void deactivate() override;
 
-private slots:
-    void slotGray();
+protected:
+    void screensChanged() override;
+
+private:
+    RSIDBusCall* m_dashboard;
 };
 
 #endif // PLASMAEFFECT_H
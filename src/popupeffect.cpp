@@ -18,6 +18,7 @@
 
 #include "popupeffect.h"
 #include "passivepopup.h"
+#include "rsiglobals.h"
 
 #include <KLocalizedString>
 
@@ -42,6 +43,12 @@ PopupEffect::~PopupEffect()
 void PopupEffect::activate()
 {
     m_popup->show();
+    RSIGlobals::instance()->activationTrace()->shownWithoutWindows();
+}
+
+void PopupEffect::prepare()
+{
+    // The popup is small, and the windows of BreakBase are never shown.
 }
 
 void PopupEffect::deactivate()
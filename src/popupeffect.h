@@ -34,6 +34,7 @@ public:
     PopupEffect( QObject* );
     ~PopupEffect();
     void setLabel( const QString& ) override;
+    void prepare() override;
 
 public slots:
     void activate() override;
@@ -0,0 +1,146 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsiactivationtrace.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+RSIActivationTrace::RSIActivationTrace()
+        : m_emitted( 0 ), m_painted( 0 ), m_tracing( false )
+{
+    for ( int i = 0; i < StageCount; ++i )
+        m_stamps[ i ] = -1;
+}
+
+static QElapsedTimer startedClock()
+{
+    QElapsedTimer clock;
+    clock.start();
+    return clock;
+}
+
+qint64 RSIActivationTrace::now()
+{
+    static const QElapsedTimer clock = startedClock();
+    // Never 0, that means not stamped.
+    return clock.nsecsElapsed() / 1000 + 1;
+}
+
+void RSIActivationTrace::breakEmitted()
+{
+    m_emitted.store( now() );
+}
+
+void RSIActivationTrace::begin( int screens )
+{
+    const qint64 delivered = now();
+    const qint64 emitted = m_emitted.exchange( 0 );
+
+    for ( int i = 0; i < StageCount; ++i )
+        m_stamps[ i ] = -1;
+    // Not started by the timer, for example through D-Bus.
+    m_stamps[ Emitted ] = emitted > 0 ? emitted : delivered;
+    m_stamps[ Delivered ] = delivered;
+
+    m_paints.fill( -1, qMax( screens, 1 ) );
+    m_painted = 0;
+    m_tracing = true;
+}
+
+void RSIActivationTrace::mark( Stage stage )
+{
+    if ( m_tracing && m_stamps[ stage ] == -1 )
+        m_stamps[ stage ] = now();
+}
+
+void RSIActivationTrace::painted( int screen )
+{
+    if ( !m_tracing || screen < 0 || screen >= m_paints.count() || m_paints.at( screen ) != -1 )
+        return;
+
+    m_paints[ screen ] = now();
+    if ( ++m_painted == m_paints.count() )
+        finish();
+}
+
+void RSIActivationTrace::shownWithoutWindows()
+{
+    if ( !m_tracing )
+        return;
+
+    const qint64 shown = now();
+    for ( int i = 0; i < m_paints.count(); ++i ) {
+        if ( m_paints.at( i ) == -1 )
+            m_paints[ i ] = shown;
+    }
+    m_painted = m_paints.count();
+    finish();
+}
+
+bool RSIActivationTrace::isComplete() const
+{
+    return m_stamps[ Painted ] != -1;
+}
+
+void RSIActivationTrace::finish()
+{
+    m_tracing = false;
+    m_stamps[ Painted ] = now();
+
+    const int latency = ( m_stamps[ Painted ] - m_stamps[ Emitted ] ) / 1000;
+    m_latencies.record( latency );
+
+    qDebug() << "Break shown after" << latency << "ms, delivered after"
+             << elapsed( Delivered ) / 1000 << "ms, activated after"
+             << elapsed( Activated ) / 1000 << "ms. Over" << m_latencies.count()
+             << "breaks p50" << m_latencies.percentile( 50 )
+             << "p90" << m_latencies.percentile( 90 )
+             << "p99" << m_latencies.percentile( 99 ) << "ms";
+}
+
+qint64 RSIActivationTrace::elapsed( Stage stage ) const
+{
+    if ( m_stamps[ stage ] == -1 )
+        return -1;
+    return m_stamps[ stage ] - m_stamps[ Emitted ];
+}
+
+qint64 RSIActivationTrace::paintElapsed( int screen ) const
+{
+    if ( screen < 0 || screen >= m_paints.count() || m_paints.at( screen ) == -1 )
+        return -1;
+    return m_paints.at( screen ) - m_stamps[ Emitted ];
+}
+
+QVariantMap RSIActivationTrace::report() const
+{
+    QVariantMap report;
+    report.insert( "delivered", elapsed( Delivered ) );
+    report.insert( "activated", elapsed( Activated ) );
+    report.insert( "painted", elapsed( Painted ) );
+
+    QVariantList paints;
+    for ( int i = 0; i < m_paints.count(); ++i )
+        paints.append( paintElapsed( i ) );
+    report.insert( "screens", paints );
+
+    report.insert( "count", m_latencies.count() );
+    report.insert( "p50", m_latencies.percentile( 50 ) );
+    report.insert( "p90", m_latencies.percentile( 90 ) );
+    report.insert( "p99", m_latencies.percentile( 99 ) );
+    return report;
+}
@@ -0,0 +1,102 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIACTIVATIONTRACE_H
+#define RSIBREAK_RSIACTIVATIONTRACE_H
+
+#include <QVariantMap>
+#include <QVector>
+
+#include <atomic>
+
+#include "rsihistogram.h"
+
+/**
+ * Measures how long it takes to show a break. The timer thread stamps the
+ * moment it emits breakNow, the GUI thread stamps when the signal is
+ * delivered, when the effect has been activated and when the first window
+ * on every screen has been painted.
+ *
+ * The latency until all screens are painted is kept in a histogram in
+ * milliseconds, and logged after every break.
+ */
+class RSIActivationTrace
+{
+public:
+    enum Stage {
+        Emitted = 0,    // breakNow was emitted by the timer thread.
+        Delivered,      // The GUI thread starts activating the effect.
+        Activated,      // The effect has shown its windows and grabbed the input.
+        Painted,        // Every screen has been painted.
+        StageCount
+    };
+
+    RSIActivationTrace();
+
+    /** @returns a monotonic clock in microseconds. */
+    static qint64 now();
+
+    /** Stamps the moment breakNow is emitted, can be called from any thread. */
+    void breakEmitted();
+
+    /**
+     * Starts tracing the break which is delivered now, for which @p screens
+     * screens have to be painted.
+     */
+    void begin( int screens );
+
+    /** Stamps @p stage of the current break. */
+    void mark( Stage stage );
+
+    /**
+     * A window on @p screen has been painted. Only the first paint of a
+     * screen during a break counts.
+     */
+    void painted( int screen );
+
+    /**
+     * The break has been shown without a window on every screen, like the
+     * popup, which counts as all screens painted.
+     */
+    void shownWithoutWindows();
+
+    /** @returns true when every screen has been painted. */
+    bool isComplete() const;
+
+    /** @returns the microseconds from Emitted to @p stage, or -1. */
+    qint64 elapsed( Stage stage ) const;
+
+    /** @returns the microseconds from Emitted to the first paint of @p screen, or -1. */
+    qint64 paintElapsed( int screen ) const;
+
+    /** @returns the latencies of the complete breaks, in milliseconds. */
+    const RSIHistogram &latencies() const { return m_latencies; }
+
+    /** @returns the stages of the last break and the latency percentiles. */
+    QVariantMap report() const;
+
+private:
+    void finish();
+
+    std::atomic<qint64> m_emitted;
+    qint64              m_stamps[StageCount];
+    QVector<qint64>     m_paints;
+    int                 m_painted;
+    bool                m_tracing;
+    RSIHistogram        m_latencies;
+};
+
+#endif //RSIBREAK_RSIACTIVATIONTRACE_H
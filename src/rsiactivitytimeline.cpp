@@ -0,0 +1,104 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiactivitytimeline.h"
+
+#include <algorithm>
+
+RSIActivityTimeline::RSIActivityTimeline( int horizon )
+        : m_first( 0 ), m_horizon( horizon ), m_length( 0 ), m_activeTotal( 0 )
+{
+    Q_ASSERT( horizon > 0 );
+}
+
+void RSIActivityTimeline::append( bool active, int seconds )
+{
+    Q_ASSERT( seconds >= 0 );
+    if ( seconds <= 0 )
+        return;
+
+    if ( active ) {
+        if ( runCount() > 0 && m_runs.last().end == m_length ) {
+            m_runs.last().end += seconds;
+        } else {
+            Run run;
+            run.begin = m_length;
+            run.end = m_length + seconds;
+            run.activeBefore = m_activeTotal;
+            m_runs.append( run );
+        }
+        m_activeTotal += seconds;
+    }
+
+    m_length += seconds;
+    trim();
+}
+
+void RSIActivityTimeline::reset()
+{
+    m_runs.clear();
+    m_first = 0;
+    m_length = 0;
+    m_activeTotal = 0;
+}
+
+qint64 RSIActivityTimeline::activeSeconds( qint64 from, qint64 to ) const
+{
+    from = qMax<qint64>( from, 0 );
+    to = qMin( to, m_length );
+    if ( from >= to )
+        return 0;
+
+    return activeUntil( to ) - activeUntil( from );
+}
+
+qint64 RSIActivityTimeline::activeSecondsInLast( int seconds ) const
+{
+    Q_ASSERT( seconds <= m_horizon );
+    return activeSeconds( m_length - seconds, m_length );
+}
+
+qint64 RSIActivityTimeline::activeUntil( qint64 t ) const
+{
+    const Run *first = m_runs.constData() + m_first;
+    const Run *last = m_runs.constData() + m_runs.count();
+
+    // First run which starts at or after t, the one before it may overlap t.
+    const Run *it = std::lower_bound( first, last, t,
+    []( const Run & run, qint64 t ) {
+        return run.begin < t;
+    } );
+
+    if ( it == first )
+        return first == last ? m_activeTotal : first->activeBefore;
+
+    --it;
+    return it->activeBefore + qMin( it->end, t ) - it->begin;
+}
+
+void RSIActivityTimeline::trim()
+{
+    const qint64 oldest = m_length - m_horizon;
+    while ( m_first < m_runs.count() && m_runs.at( m_first ).end <= oldest )
+        ++m_first;
+
+    // Compact once the dropped runs take up half of the list, which keeps
+    // the cost of appending constant on average.
+    if ( m_first > 32 && m_first * 2 > m_runs.count() ) {
+        m_runs.remove( 0, m_first );
+        m_first = 0;
+    }
+}
@@ -0,0 +1,82 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIACTIVITYTIMELINE_H
+#define RSIBREAK_RSIACTIVITYTIMELINE_H
+
+#include <QVector>
+
+/**
+ * Keeps track per second when the user was active, as a list of runs of
+ * activity. Time is counted in seconds since the last reset, every call to
+ * append() adds to the end of the timeline.
+ *
+ * Appending is constant time: it either extends the last run or starts a
+ * new one when the user becomes active. Every run also stores how many
+ * active seconds came before it, so the activity in any window is found
+ * with a binary search over the runs.
+ *
+ * Runs which ended longer than the horizon ago are dropped.
+ */
+class RSIActivityTimeline
+{
+public:
+    /** @param horizon How many seconds of history are kept at least. */
+    explicit RSIActivityTimeline( int horizon = 60 * 60 * 24 );
+
+    /** Adds @p seconds seconds of activity or idleness to the timeline. */
+    void append( bool active, int seconds = 1 );
+
+    /** Removes all history. */
+    void reset();
+
+    /** @returns the amount of seconds recorded since the last reset. */
+    qint64 length() const { return m_length; }
+
+    /** @returns the amount of seconds of history which are kept. */
+    int horizon() const { return m_horizon; }
+
+    /** @returns the amount of active seconds in [ @p from, @p to ). */
+    qint64 activeSeconds( qint64 from, qint64 to ) const;
+
+    /** @returns the amount of active seconds in the last @p seconds. */
+    qint64 activeSecondsInLast( int seconds ) const;
+
+    /** @returns the amount of runs of activity in memory. */
+    int runCount() const { return m_runs.count() - m_first; }
+
+private:
+    // Amount of active seconds in [ 0, @p t ).
+    qint64 activeUntil( qint64 t ) const;
+
+    // Drops the runs which are beyond the horizon.
+    void trim();
+
+    struct Run {
+        qint64 begin;
+        qint64 end;
+        // Active seconds before this run, since the last reset.
+        qint64 activeBefore;
+    };
+
+    QVector<Run> m_runs;
+    int m_first;            // first run within the horizon.
+    int m_horizon;
+    qint64 m_length;
+    qint64 m_activeTotal;
+};
+
+#endif //RSIBREAK_RSIACTIVITYTIMELINE_H
@@ -0,0 +1,61 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsibreakpreparation.h"
+
+#include <QtGlobal>
+
+RSIBreakPreparation::RSIBreakPreparation()
+        : m_prepareSeconds( 0 ), m_prepared( false ), m_inBreak( false )
+{
+}
+
+void RSIBreakPreparation::setPrepareSeconds( int seconds )
+{
+    m_prepareSeconds = seconds;
+}
+
+RSIBreakPreparation::Action RSIBreakPreparation::update( int tinyLeft, int bigLeft )
+{
+    // The counters start over as soon as a break begins, that is no reason
+    // to let go of the effect which is about to be shown.
+    if ( m_inBreak )
+        return Nothing;
+
+    const int left = qMin( tinyLeft, bigLeft );
+    if ( !m_prepared && left > 0 && left <= m_prepareSeconds ) {
+        m_prepared = true;
+        return Prepare;
+    }
+
+    // Idle long enough to skip the break, the counters were reset.
+    if ( m_prepared && left > m_prepareSeconds ) {
+        m_prepared = false;
+        return Release;
+    }
+    return Nothing;
+}
+
+void RSIBreakPreparation::breakStarted()
+{
+    m_inBreak = true;
+}
+
+void RSIBreakPreparation::reset()
+{
+    m_prepared = false;
+    m_inBreak = false;
+}
@@ -0,0 +1,57 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIBREAKPREPARATION_H
+#define RSIBREAK_RSIBREAKPREPARATION_H
+
+/**
+ * Decides when the break effect is prepared ahead of a break, and when a
+ * prepared effect is released again because the break did not come: the
+ * user was idle long enough for the timer to reset the counters.
+ *
+ * It only decides, RSIObject acts on the effect.
+ */
+class RSIBreakPreparation
+{
+public:
+    enum Action { Nothing, Prepare, Release };
+
+    RSIBreakPreparation();
+
+    /** Seconds before a break the effect is prepared, 0 to never. */
+    void setPrepareSeconds( int seconds );
+
+    /**
+     * Called with the counters on every tick.
+     * @returns what to do with the effect.
+     */
+    Action update( int tinyLeft, int bigLeft );
+
+    /** A break is suggested or shown, the prepared effect is needed now. */
+    void breakStarted();
+
+    /** The break is over or the effect changed, nothing is prepared anymore. */
+    void reset();
+
+    bool isPrepared() const { return m_prepared; }
+
+private:
+    int     m_prepareSeconds;
+    bool    m_prepared;
+    bool    m_inBreak;
+};
+
+#endif //RSIBREAK_RSIBREAKPREPARATION_H
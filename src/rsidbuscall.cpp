@@ -0,0 +1,82 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsidbuscall.h"
+#include "rsiactivationtrace.h"
+
+#include <QDBusConnection>
+#include <QDBusPendingCallWatcher>
+#include <QDebug>
+
+// A reply which takes longer than this is not going to help the break.
+static const int defaultTimeout = 5000;
+
+RSIDBusCall::RSIDBusCall( const QString &service, const QString &path, const QString &interface,
+                          const QString &method, QObject *parent )
+        : QObject( parent ), m_timeout( defaultTimeout ), m_calls( 0 ), m_errors( 0 ), m_timeouts( 0 )
+{
+    m_message = QDBusMessage::createMethodCall( service, path, interface, method );
+}
+
+void RSIDBusCall::setTimeout( int timeout )
+{
+    m_timeout = timeout;
+}
+
+void RSIDBusCall::call( const QVariantList &arguments )
+{
+    QDBusMessage message = m_message;
+    message.setArguments( arguments );
+
+    ++m_calls;
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
+        QDBusConnection::sessionBus().asyncCall( message, m_timeout ), this );
+    m_pending.insert( watcher, RSIActivationTrace::now() );
+    connect( watcher, &QDBusPendingCallWatcher::finished, this, &RSIDBusCall::slotFinished );
+}
+
+void RSIDBusCall::slotFinished( QDBusPendingCallWatcher *watcher )
+{
+    const qint64 started = m_pending.take( watcher );
+    watcher->deleteLater();
+
+    if ( watcher->isError() ) {
+        const QDBusError error = watcher->error();
+        if ( error.type() == QDBusError::NoReply || error.type() == QDBusError::Timeout )
+            ++m_timeouts;
+        else
+            ++m_errors;
+        m_lastError = error.name() + ": " + error.message();
+        qWarning() << m_message.member() << "failed:" << m_lastError;
+        return;
+    }
+
+    m_latencies.record( int( ( RSIActivationTrace::now() - started ) / 1000 ) );
+}
+
+QVariantMap RSIDBusCall::report() const
+{
+    QVariantMap report;
+    report.insert( "calls", m_calls );
+    report.insert( "pending", pending() );
+    report.insert( "errors", m_errors );
+    report.insert( "timeouts", m_timeouts );
+    report.insert( "lastError", m_lastError );
+    report.insert( "p50", m_latencies.percentile( 50 ) );
+    report.insert( "p90", m_latencies.percentile( 90 ) );
+    report.insert( "p99", m_latencies.percentile( 99 ) );
+    return report;
+}
@@ -0,0 +1,79 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIDBUSCALL_H
+#define RSIBREAK_RSIDBUSCALL_H
+
+#include <QDBusMessage>
+#include <QHash>
+#include <QObject>
+#include <QVariantMap>
+
+#include "rsihistogram.h"
+
+class QDBusPendingCallWatcher;
+
+/**
+ * A D-Bus method call which never blocks the GUI thread. The message is
+ * built once, without the introspection a QDBusInterface does, and sent
+ * asynchronously. The reply is handled by a watcher when it comes in, or
+ * counted as a timeout when it does not come in time.
+ *
+ * The round trips are kept in a histogram in milliseconds, together with
+ * the amount of errors and timeouts.
+ */
+class RSIDBusCall : public QObject
+{
+    Q_OBJECT
+
+public:
+    RSIDBusCall( const QString &service, const QString &path, const QString &interface,
+                 const QString &method, QObject *parent = 0 );
+
+    /** Sets how long to wait for a reply, in milliseconds. */
+    void setTimeout( int timeout );
+
+    /** Sends the call with @p arguments and returns right away. */
+    void call( const QVariantList &arguments = QVariantList() );
+
+    /** @returns the amount of calls which did not get a reply yet. */
+    int pending() const { return m_pending.count(); }
+
+    quint64 calls() const { return m_calls; }
+    quint64 errors() const { return m_errors; }
+    quint64 timeouts() const { return m_timeouts; }
+
+    /** @returns the round trips of the calls which got a reply, in milliseconds. */
+    const RSIHistogram &latencies() const { return m_latencies; }
+
+    /** @returns the counts, the last error and the round trip percentiles. */
+    QVariantMap report() const;
+
+private slots:
+    void slotFinished( QDBusPendingCallWatcher *watcher );
+
+private:
+    QDBusMessage    m_message;
+    int             m_timeout;
+    QHash<QDBusPendingCallWatcher*, qint64> m_pending;
+    quint64         m_calls;
+    quint64         m_errors;
+    quint64         m_timeouts;
+    QString         m_lastError;
+    RSIHistogram    m_latencies;
+};
+
+#endif //RSIBREAK_RSIDBUSCALL_H
@@ -24,6 +24,7 @@
 #include "setup.h"
 #include "rsistatwidget.h"
 #include "rsistats.h"
+#include "rsistatsmodel.h"
 
 #include <QPointer>
 #include <QTextDocument>
@@ -193,7 +194,7 @@ void RSIDock::slotResetStats()
             "resetStatistics" );
 
     if ( i == KMessageBox::Continue )
-        RSIGlobals::instance()->stats()->reset();
+        emit resetStats();
 }
 
 static QString colorizedText( const QString& text, const QColor& color )
@@ -210,10 +211,14 @@ void RSIDock::setCounters( int tiny_left, int big_left )
         setToolTipSubTitle( i18n( "Suspended" ) );
     else {
         QColor tinyColor = RSIGlobals::instance()->getTinyBreakColor( tiny_left );
-        RSIGlobals::instance()->stats()->setColor( LAST_TINY_BREAK, tinyColor );
-
         QColor bigColor = RSIGlobals::instance()-> getBigBreakColor( big_left );
-        RSIGlobals::instance()->stats()->setColor( LAST_BIG_BREAK, bigColor );
+
+        // The statistics model only exists once the statistics were shown.
+        if ( m_statsWidget ) {
+            RSIStatsModel *model = RSIGlobals::instance()->stats()->model();
+            model->setColor( LAST_TINY_BREAK, tinyColor );
+            model->setColor( LAST_BIG_BREAK, bigColor );
+        }
 
         // Only add the line for the tiny break when there is not
         // a big break planned at the same time.
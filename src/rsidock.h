@@ -94,6 +94,12 @@ signals:
     */
     void suspend( bool );
 
+    /**
+     * The user wants to reset the statistics. As the timer is the only
+     * one changing the statistics, it should handle this request.
+     */
+    void resetStats();
+
 private slots:
     void slotConfigure();
     void slotConfigureNotifications();
@@ -0,0 +1,74 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsiframestats.h"
+
+#include <climits>
+
+RSIFrameStats::RSIFrameStats()
+        : m_dropped( 0 ), m_transitions( 0 ), m_renderTime( 0 ), m_blendTime( 0 ), m_duration( 0 )
+{
+}
+
+void RSIFrameStats::recordFrame( qint64 renderTime, int dropped )
+{
+    m_frameTimes.record( int( qMin( renderTime, qint64( INT_MAX ) ) ) );
+    m_renderTime += renderTime;
+    m_dropped += qMax( dropped, 0 );
+}
+
+void RSIFrameStats::recordBlend( qint64 blendTime )
+{
+    m_blendTime += blendTime;
+}
+
+void RSIFrameStats::recordTransition( qint64 duration )
+{
+    ++m_transitions;
+    m_duration += duration;
+}
+
+void RSIFrameStats::reset()
+{
+    m_frameTimes.reset();
+    m_dropped = 0;
+    m_transitions = 0;
+    m_renderTime = 0;
+    m_blendTime = 0;
+    m_duration = 0;
+}
+
+double RSIFrameStats::cpuShare() const
+{
+    if ( m_duration <= 0 )
+        return 0;
+    return 100.0 * ( m_renderTime + m_blendTime ) / m_duration;
+}
+
+QVariantMap RSIFrameStats::report() const
+{
+    QVariantMap report;
+    report.insert( "transitions", m_transitions );
+    report.insert( "frames", frames() );
+    report.insert( "dropped", m_dropped );
+    report.insert( "p50", m_frameTimes.percentile( 50 ) );
+    report.insert( "p90", m_frameTimes.percentile( 90 ) );
+    report.insert( "p99", m_frameTimes.percentile( 99 ) );
+    report.insert( "renderTime", m_renderTime );
+    report.insert( "blendTime", m_blendTime );
+    report.insert( "cpuShare", cpuShare() );
+    return report;
+}
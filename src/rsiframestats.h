@@ -0,0 +1,72 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIFRAMESTATS_H
+#define RSIBREAK_RSIFRAMESTATS_H
+
+#include <QVariantMap>
+
+#include "rsihistogram.h"
+
+/**
+ * Keeps the frame times of the fades and cross-fades. Every frame records
+ * the time the GUI thread spent on it in microseconds, and the frames which
+ * were skipped because it came late. The frames which are blended ahead of
+ * time on a worker count with the time spent blending them.
+ *
+ * Together with the duration of the transitions this gives the share of a
+ * CPU they take, which should stay low on a software rendered X server.
+ */
+class RSIFrameStats
+{
+public:
+    RSIFrameStats();
+
+    /** Counts a frame which took @p renderTime microseconds, after @p dropped skipped frames. */
+    void recordFrame( qint64 renderTime, int dropped );
+
+    /** Counts a frame blended on a worker in @p blendTime microseconds. */
+    void recordBlend( qint64 blendTime );
+
+    /** Counts a transition which ran for @p duration microseconds. */
+    void recordTransition( qint64 duration );
+
+    /** Removes everything recorded. */
+    void reset();
+
+    /** @returns the time spent on each frame, in microseconds. */
+    const RSIHistogram &frameTimes() const { return m_frameTimes; }
+
+    quint64 frames() const { return m_frameTimes.count(); }
+    quint64 droppedFrames() const { return m_dropped; }
+    quint64 transitions() const { return m_transitions; }
+
+    /** @returns the percentage of the transitions spent rendering and blending. */
+    double cpuShare() const;
+
+    /** @returns the frame counts, the frame time percentiles and the CPU share. */
+    QVariantMap report() const;
+
+private:
+    RSIHistogram m_frameTimes;
+    quint64      m_dropped;
+    quint64      m_transitions;
+    qint64       m_renderTime;
+    qint64       m_blendTime;
+    qint64       m_duration;
+};
+
+#endif //RSIBREAK_RSIFRAMESTATS_H
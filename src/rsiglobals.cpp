@@ -21,13 +21,12 @@
 
 #include <qdebug.h>
 #include <kconfig.h>
-#include <klocalizedstring.h>
-#include <knotification.h>
 #include <kconfiggroup.h>
 #include <ksharedconfig.h>
 
 #include <math.h>
 
+#include "rsinotifier.h"
 #include "rsistats.h"
 
 RSIGlobals *RSIGlobals::m_instance = 0;
@@ -36,6 +35,7 @@ RSIStats *RSIGlobals::m_stats = 0;
 RSIGlobals::RSIGlobals( QObject *parent )
         : QObject( parent )
 {
+    m_notifier = new RSINotifier( this );
     resetUsage();
     slotReadConfig();
 }
@@ -75,6 +75,11 @@ void RSIGlobals::slotReadConfig()
     m_intervals[POSTPONE_BREAK_INTERVAL] = config.readEntry( "PostponeBreakDuration", 5 ) * 60;
     m_intervals[PATIENCE_INTERVAL] = config.readEntry( "Patience", 30 );
 
+    m_notifier->setCommands( config.readEntry( "BreakStartCommand", QString() ),
+                             config.readEntry( "BreakEndCommand", QString() ) );
+    m_notifier->setLimits( config.readEntry( "HookProcesses", 4 ),
+                           config.readEntry( "HookTimeout", 10 ) * 1000 );
+
     if ( config.readEntry( "DEBUG", 0 ) > 0 ) {
         qDebug() << "Debug mode activated";
         m_intervals[TINY_BREAK_INTERVAL] = m_intervals[TINY_BREAK_INTERVAL] / 60;
@@ -108,19 +113,10 @@ QColor RSIGlobals::getBigBreakColor( int secsToBreak ) const
 
 void RSIGlobals::resetUsage()
 {
-    m_usageArray.fill( false, 60 * 60 * 24 );
+    m_activityTimeline.reset();
 }
 
 void RSIGlobals::NotifyBreak( bool start, bool big )
 {
-    if ( start )
-        big ? KNotification::event( "start long break",
-                                    i18n( "Start of a long break" ) )
-        : KNotification::event( "start short break",
-                                i18n( "Start of a short break" ) );
-    else
-        big ? KNotification::event( "end long break",
-                                    i18n( "End of a long break" ) )
-        : KNotification::event( "end short break",
-                                i18n( "End of a short break" ) );
+    m_notifier->notifyBreak( start, big );
 }
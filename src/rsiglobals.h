@@ -19,7 +19,6 @@
 #ifndef RSIGLOBALS_H
 #define RSIGLOBALS_H
 
-#include <QBitArray>
 #include <qmap.h>
 #include <QObject>
 #include <QStringList>
@@ -27,6 +26,11 @@
 #include <kformat.h>
 #include <kpassivepopup.h>
 
+#include "rsiactivationtrace.h"
+#include "rsiactivitytimeline.h"
+#include "rsiframestats.h"
+
+class RSINotifier;
 class RSIStats;
 
 enum RSIStat {
@@ -50,6 +54,15 @@ enum RSIStat {
     BIG_BREAKS_POSTPONED,
     LAST_BIG_BREAK,
     PAUSE_SCORE,
+    IDLE_PERIOD_P50,
+    IDLE_PERIOD_P90,
+    IDLE_PERIOD_P99,
+    WORK_STREAK_P50,
+    WORK_STREAK_P90,
+    WORK_STREAK_P99,
+    ACTIVITY_EWMA_HOUR,
+    ACTIVITY_EWMA_DAY,
+    ACTIVITY_EWMA_WEEK,
     STAT_COUNT
 };
 
@@ -125,25 +138,54 @@ public:
     QColor getBigBreakColor( int secsToBreak ) const;
 
     /**
-     * Returns the array which keeps track per second for 24 hours when the
-     * user was active or idle. Activity = 1, idle = 0.
-     * The RSIStatBitArrayItem can read and write a certain interval of this
-     * array, for example to measure the activity in 60 seconds or 1 hour.
+     * Returns the timeline which keeps track per second for 24 hours when the
+     * user was active or idle. RSIStats appends to it every second, the
+     * RSIStatActivityItem reads a certain window of it, for example to
+     * measure the activity in 60 seconds or 1 hour.
      *
-     * @see RSIStatBitArrayItem
+     * @see RSIStatActivityItem
      */
-    QBitArray *usageArray() {
-        return &m_usageArray;
+    RSIActivityTimeline *activityTimeline() {
+        return &m_activityTimeline;
     }
 
     /**
-     * Resets the usage array, with all values to 0.
+     * Clears the activity timeline.
      */
     void resetUsage();
 
+    /**
+     * Returns the trace of the last break which was shown, the effects
+     * stamp when their windows are painted.
+     *
+     * @see RSIActivationTrace
+     */
+    RSIActivationTrace *activationTrace() {
+        return &m_activationTrace;
+    }
+
+    /**
+     * Returns the frame times of the fades and cross-fades.
+     *
+     * @see RSIFrameStats
+     */
+    RSIFrameStats *frameStats() {
+        return &m_frameStats;
+    }
+
+    /**
+     * Returns the notifier, which runs the hooks of the user too.
+     *
+     * @see RSINotifier
+     */
+    RSINotifier *notifier() {
+        return m_notifier;
+    }
+
     /**
      *
-     * Hook to KDE's Notifying system at start/end of a break.
+     * Hook to KDE's Notifying system at start/end of a break. Returns
+     * right away, the notification is sent from the GUI thread.
      * @param start when true the start commands are executed, false executes
      *              the ones at the end of a break.
      * @param big   true for big breaks, false for short ones.
@@ -160,7 +202,10 @@ private:
     static RSIGlobals *m_instance;
     static RSIStats *m_stats;
     QVector<int> m_intervals;
-    QBitArray m_usageArray;
+    RSIActivityTimeline m_activityTimeline;
+    RSIActivationTrace m_activationTrace;
+    RSIFrameStats m_frameStats;
+    RSINotifier *m_notifier;
     KFormat m_format;
 };
 
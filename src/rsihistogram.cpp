@@ -0,0 +1,139 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsihistogram.h"
+
+#include <cmath>
+#include <cstring>
+
+// Position of the highest set bit, in a fixed amount of steps.
+static int highestBit( quint32 v )
+{
+    int bit = 0;
+    if ( v >= 1u << 16 ) {
+        v >>= 16;
+        bit += 16;
+    }
+    if ( v >= 1u << 8 ) {
+        v >>= 8;
+        bit += 8;
+    }
+    if ( v >= 1u << 4 ) {
+        v >>= 4;
+        bit += 4;
+    }
+    if ( v >= 1u << 2 ) {
+        v >>= 2;
+        bit += 2;
+    }
+    if ( v >= 1u << 1 )
+        bit += 1;
+    return bit;
+}
+
+RSIHistogram::RSIHistogram()
+{
+    reset();
+}
+
+void RSIHistogram::reset()
+{
+    std::memset( m_counts, 0, sizeof( m_counts ) );
+    m_total = 0;
+}
+
+int RSIHistogram::bucketIndex( int seconds )
+{
+    const quint32 v = seconds > 0 ? seconds : 0;
+
+    // The first two ranges have a bucket for every value.
+    if ( v < 2 * SubBucketCount )
+        return v;
+
+    const int msb = highestBit( v );
+    const int shift = msb - SubBucketBits;
+    const int sub = ( v >> shift ) - SubBucketCount;
+    return 2 * SubBucketCount + ( msb - SubBucketBits - 1 ) * SubBucketCount + sub;
+}
+
+int RSIHistogram::bucketUpperBound( int index )
+{
+    if ( index < 2 * SubBucketCount )
+        return index;
+
+    const int msb = SubBucketBits + 1 + ( index - 2 * SubBucketCount ) / SubBucketCount;
+    const int sub = ( index - 2 * SubBucketCount ) % SubBucketCount;
+    const int shift = msb - SubBucketBits;
+    const quint32 lower = quint32( SubBucketCount + sub ) << shift;
+    return lower + ( ( 1u << shift ) - 1 );
+}
+
+void RSIHistogram::record( int seconds )
+{
+    ++m_counts[ bucketIndex( seconds ) ];
+    ++m_total;
+}
+
+void RSIHistogram::merge( const RSIHistogram &other )
+{
+    for ( int i = 0; i < BucketCount; ++i )
+        m_counts[ i ] += other.m_counts[ i ];
+    m_total += other.m_total;
+}
+
+int RSIHistogram::percentile( double percent ) const
+{
+    if ( m_total == 0 )
+        return 0;
+
+    percent = qBound( 0.0, percent, 100.0 );
+    const quint64 wanted = qMax<quint64>( 1, quint64( std::ceil( percent / 100.0 * m_total ) ) );
+
+    quint64 seen = 0;
+    for ( int i = 0; i < BucketCount; ++i ) {
+        seen += m_counts[ i ];
+        if ( seen >= wanted )
+            return bucketUpperBound( i );
+    }
+
+    return bucketUpperBound( BucketCount - 1 );
+}
+
+QList<uint> RSIHistogram::counts() const
+{
+    QList<uint> result;
+    result.reserve( BucketCount );
+    for ( int i = 0; i < BucketCount; ++i )
+        result << m_counts[ i ];
+    return result;
+}
+
+RSIHistogram RSIHistogram::fromCounts( const QList<uint> &counts )
+{
+    RSIHistogram histogram;
+    const int n = qMin( counts.count(), int( BucketCount ) );
+    for ( int i = 0; i < n; ++i ) {
+        histogram.m_counts[ i ] = counts.at( i );
+        histogram.m_total += counts.at( i );
+    }
+    return histogram;
+}
+
+bool RSIHistogram::operator==( const RSIHistogram &other ) const
+{
+    return m_total == other.m_total &&
+           std::memcmp( m_counts, other.m_counts, sizeof( m_counts ) ) == 0;
+}
@@ -0,0 +1,79 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIHISTOGRAM_H
+#define RSIBREAK_RSIHISTOGRAM_H
+
+#include <QList>
+#include <QtGlobal>
+
+/**
+ * A histogram of durations in seconds with logarithmic buckets, in the
+ * spirit of HdrHistogram. Values below 16 seconds are counted exactly,
+ * larger values are counted in 8 buckets per power of two, so every value
+ * is known within 12.5%.
+ *
+ * The histogram has a fixed size, recording a value is constant time and
+ * two histograms are merged by adding up their buckets. This makes it cheap
+ * to keep one for the whole session and to aggregate them over many users.
+ */
+class RSIHistogram
+{
+public:
+    static constexpr int SubBucketBits = 3;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int BucketCount = 2 * SubBucketCount + ( 31 - SubBucketBits - 1 ) * SubBucketCount;
+
+    RSIHistogram();
+
+    /** Counts one occurrence of @p seconds. Negative values count as zero. */
+    void record( int seconds );
+
+    /** Removes all recorded values. */
+    void reset();
+
+    /** Adds all values recorded in @p other to this histogram. */
+    void merge( const RSIHistogram &other );
+
+    /** @returns the amount of recorded values. */
+    quint64 count() const { return m_total; }
+
+    /**
+     * @returns the value below which @p percent percent of the recorded
+     * values fall, rounded up to the end of its bucket. 0 when empty.
+     */
+    int percentile( double percent ) const;
+
+    /** @returns the count of each bucket, for example to export it. */
+    QList<uint> counts() const;
+
+    /** Creates a histogram from bucket counts as returned by counts(). */
+    static RSIHistogram fromCounts( const QList<uint> &counts );
+
+    /** @returns the bucket @p seconds is counted in. */
+    static int bucketIndex( int seconds );
+
+    /** @returns the highest value counted in bucket @p index. */
+    static int bucketUpperBound( int index );
+
+    bool operator==( const RSIHistogram &other ) const;
+
+private:
+    quint32 m_counts[BucketCount];
+    quint64 m_total;
+};
+
+#endif //RSIBREAK_RSIHISTOGRAM_H
@@ -0,0 +1,191 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsinotifier.h"
+
+#include <KLocalizedString>
+#include <KNotification>
+
+#include <QDebug>
+#include <QTimer>
+
+// Hooks which can not start wait here, the oldest are dropped beyond this.
+static const int maximumQueued = 16;
+
+RSINotifier::RSINotifier( QObject *parent )
+        : QObject( parent ), m_maxProcesses( 4 ), m_timeout( 10000 ), m_notifications( true ),
+          m_started( 0 ), m_failed( 0 ), m_timeouts( 0 ), m_dropped( 0 )
+{
+}
+
+void RSINotifier::setCommands( const QString &start, const QString &end )
+{
+    m_startCommand = start.trimmed();
+    m_endCommand = end.trimmed();
+}
+
+void RSINotifier::setLimits( int processes, int timeout )
+{
+    m_maxProcesses = qMax( processes, 1 );
+    m_timeout = timeout;
+    startHooks();
+}
+
+void RSINotifier::setNotificationsEnabled( bool enabled )
+{
+    m_notifications = enabled;
+}
+
+void RSINotifier::notifyBreak( bool start, bool big )
+{
+    // Called from the timer thread, which should never wait for this.
+    QMetaObject::invokeMethod( this, "slotNotify", Qt::QueuedConnection,
+                               Q_ARG( bool, start ), Q_ARG( bool, big ) );
+}
+
+void RSINotifier::slotNotify( bool start, bool big )
+{
+    if ( m_notifications ) {
+        if ( start )
+            big ? KNotification::event( "start long break",
+                                        i18n( "Start of a long break" ) )
+            : KNotification::event( "start short break",
+                                    i18n( "Start of a short break" ) );
+        else
+            big ? KNotification::event( "end long break",
+                                        i18n( "End of a long break" ) )
+            : KNotification::event( "end short break",
+                                    i18n( "End of a short break" ) );
+    }
+
+    const QString command = start ? m_startCommand : m_endCommand;
+    if ( command.isEmpty() )
+        return;
+
+    if ( m_queue.count() >= maximumQueued ) {
+        qWarning() << "Too many hooks waiting, dropping" << m_queue.head().command;
+        m_queue.dequeue();
+        ++m_dropped;
+    }
+
+    Hook hook;
+    hook.command = command;
+    hook.start = start;
+    hook.big = big;
+    m_queue.enqueue( hook );
+    startHooks();
+}
+
+void RSINotifier::startHooks()
+{
+    while ( m_running.count() < m_maxProcesses && !m_queue.isEmpty() ) {
+        const Hook hook = m_queue.dequeue();
+
+        QProcess *process = new QProcess( this );
+        process->setProperty( "command", hook.command );
+        process->setStandardInputFile( QProcess::nullDevice() );
+        process->setStandardOutputFile( QProcess::nullDevice() );
+        process->setStandardErrorFile( QProcess::nullDevice() );
+
+        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+        environment.insert( "RSIBREAK_EVENT", hook.start ? "start" : "end" );
+        environment.insert( "RSIBREAK_BREAK", hook.big ? "long" : "short" );
+        process->setProcessEnvironment( environment );
+
+        connect( process, static_cast<void (QProcess::*)( int, QProcess::ExitStatus )>( &QProcess::finished ),
+                 this, &RSINotifier::slotFinished );
+        connect( process, static_cast<void (QProcess::*)( QProcess::ProcessError )>( &QProcess::error ),
+                 this, &RSINotifier::slotError );
+
+        if ( m_timeout > 0 ) {
+            QTimer *timer = new QTimer( process );
+            timer->setSingleShot( true );
+            connect( timer, &QTimer::timeout, this, &RSINotifier::slotTimeout );
+            timer->start( m_timeout );
+        }
+
+        m_running.insert( process );
+        ++m_started;
+        process->start( "/bin/sh", QStringList() << "-c" << hook.command );
+    }
+}
+
+void RSINotifier::slotTimeout()
+{
+    QProcess *process = qobject_cast<QProcess*>( sender()->parent() );
+    if ( !process || !m_running.contains( process ) )
+        return;
+
+    qWarning() << "Hook" << process->property( "command" ).toString() << "timed out";
+    ++m_timeouts;
+    m_killed.insert( process );
+    process->kill();
+}
+
+void RSINotifier::slotFinished( int exitCode, QProcess::ExitStatus status )
+{
+    QProcess *process = qobject_cast<QProcess*>( sender() );
+    if ( !process || !m_running.contains( process ) )
+        return;
+
+    // A hook which was killed for taking too long is counted already.
+    if ( m_killed.contains( process ) ) {
+        exitCode = -1;
+    } else if ( status != QProcess::NormalExit ) {
+        exitCode = -1;
+        ++m_failed;
+    } else if ( exitCode != 0 ) {
+        ++m_failed;
+    }
+    finish( process, exitCode );
+}
+
+void RSINotifier::slotError( QProcess::ProcessError error )
+{
+    // Other errors are followed by finished().
+    if ( error != QProcess::FailedToStart )
+        return;
+
+    QProcess *process = qobject_cast<QProcess*>( sender() );
+    if ( !process || !m_running.contains( process ) )
+        return;
+
+    qWarning() << "Hook" << process->property( "command" ).toString() << "could not start";
+    ++m_failed;
+    finish( process, -1 );
+}
+
+void RSINotifier::finish( QProcess *process, int exitCode )
+{
+    m_running.remove( process );
+    m_killed.remove( process );
+    process->deleteLater();
+
+    emit hookFinished( process->property( "command" ).toString(), exitCode );
+    startHooks();
+}
+
+QVariantMap RSINotifier::report() const
+{
+    QVariantMap report;
+    report.insert( "started", m_started );
+    report.insert( "failed", m_failed );
+    report.insert( "timeouts", m_timeouts );
+    report.insert( "dropped", m_dropped );
+    report.insert( "running", running() );
+    report.insert( "queued", queued() );
+    return report;
+}
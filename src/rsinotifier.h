@@ -0,0 +1,104 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSINOTIFIER_H
+#define RSIBREAK_RSINOTIFIER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QQueue>
+#include <QSet>
+#include <QVariantMap>
+
+/**
+ * Announces the start and the end of the breaks. The timer thread only
+ * queues the event, the notification is sent and the hook commands of the
+ * user are started on the thread of the notifier, the GUI thread.
+ *
+ * A hook is a shell command, it gets RSIBREAK_EVENT set to "start" or "end"
+ * and RSIBREAK_BREAK set to "short" or "long". Only a few hooks run at the
+ * same time, the others wait in a short queue, and a hook which runs too
+ * long is killed.
+ */
+class RSINotifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RSINotifier( QObject *parent = 0 );
+
+    /** Sets the commands run at the start and the end of a break, empty for none. */
+    void setCommands( const QString &start, const QString &end );
+
+    /**
+     * Runs at most @p processes hooks at the same time, and kills a hook
+     * after @p timeout milliseconds.
+     */
+    void setLimits( int processes, int timeout );
+
+    /** Sends the notifications of the desktop too, on by default. */
+    void setNotificationsEnabled( bool enabled );
+
+    /**
+     * Announces the start or the end of a break. Can be called from any
+     * thread and returns right away.
+     */
+    void notifyBreak( bool start, bool big );
+
+    /** @returns the amount of hooks which are running. */
+    int running() const { return m_running.count(); }
+
+    /** @returns the amount of hooks waiting for a process. */
+    int queued() const { return m_queue.count(); }
+
+    /** @returns the amount of hooks which were started, failed, timed out or dropped. */
+    QVariantMap report() const;
+
+signals:
+    /** A hook ended, @p exitCode is -1 when it could not start or was killed. */
+    void hookFinished( const QString &command, int exitCode );
+
+private slots:
+    void slotNotify( bool start, bool big );
+    void slotFinished( int exitCode, QProcess::ExitStatus status );
+    void slotError( QProcess::ProcessError error );
+    void slotTimeout();
+
+private:
+    struct Hook {
+        QString command;
+        bool    start;
+        bool    big;
+    };
+
+    void startHooks();
+    void finish( QProcess *process, int exitCode );
+
+    QString             m_startCommand;
+    QString             m_endCommand;
+    int                 m_maxProcesses;
+    int                 m_timeout;
+    bool                m_notifications;
+    QQueue<Hook>        m_queue;
+    QSet<QProcess*>     m_running;
+    QSet<QProcess*>     m_killed;
+    quint64             m_started;
+    quint64             m_failed;
+    quint64             m_timeouts;
+    quint64             m_dropped;
+};
+
+#endif //RSIBREAK_RSINOTIFIER_H
@@ -19,15 +19,11 @@
 
 #include "rsistatitem.h"
 
-#include <QLabel>
-
-const int totalarraysize = 60 * 60 * 24;
+#include <math.h>
 
 RSIStatItem::RSIStatItem( const QString &description, const QVariant &init )
+        : m_value( init ), m_init( init ), m_description( description )
 {
-    m_description = new QLabel( description, 0 );
-    m_value = init;
-    m_init = init;
 }
 
 RSIStatItem::~RSIStatItem() {}
@@ -43,55 +39,49 @@ void RSIStatItem::reset()
 }
 
 
-RSIStatBitArrayItem::RSIStatBitArrayItem( const QString &description, const QVariant &init, int size )
-        : RSIStatItem( description, init ), m_size( size ), m_counter( 0 )
+RSIStatActivityItem::RSIStatActivityItem( const QString &description, const QVariant &init, int size )
+        : RSIStatItem( description, init ), m_size( size )
 {
-    Q_ASSERT( size <= totalarraysize );
-
-    m_end = 0;
-    m_begin = totalarraysize - size;
+    Q_ASSERT( size <= RSIGlobals::instance()->activityTimeline()->horizon() );
 }
 
-RSIStatBitArrayItem::~RSIStatBitArrayItem() {}
+RSIStatActivityItem::~RSIStatActivityItem() {}
 
-void RSIStatBitArrayItem::reset()
+void RSIStatActivityItem::update()
 {
-    RSIStatItem::reset();
-    RSIGlobals::instance()->resetUsage();
+    const qint64 active = RSIGlobals::instance()->activityTimeline()->activeSecondsInLast( m_size );
+
+    Q_ASSERT( active <= m_size );
 
-    m_end = 0;
-    m_begin = totalarraysize - m_size;
-    m_counter = 0;
+    m_value = QVariant( 100.0 * ( double )( active ) / ( double )( m_size ) );
 }
 
-void RSIStatBitArrayItem::setActivity()
+RSIStatEwmaItem::RSIStatEwmaItem( const QString &description, int timeConstant )
+        : RSIStatItem( description, QVariant( 0.0 ) ),
+          m_decay( exp( -1.0 / timeConstant ) ), m_average( 0.0 )
 {
-    QBitArray *array = RSIGlobals::instance()->usageArray();
-
-    if ( !array->testBit( m_begin ) )
-        ++m_counter;
-
-    array->setBit( m_end );
+    Q_ASSERT( timeConstant > 0 );
+}
 
-    Q_ASSERT( m_counter <= m_size );
+RSIStatEwmaItem::~RSIStatEwmaItem() {}
 
-    m_value = QVariant( 100.0 * ( double )( m_counter ) / ( double )( m_size ) );
-    m_begin = ( m_begin + 1 ) % totalarraysize;
-    m_end = ( m_end + 1 ) % totalarraysize;
+void RSIStatEwmaItem::reset()
+{
+    RSIStatItem::reset();
+    m_average = 0.0;
 }
 
-void RSIStatBitArrayItem::setIdle()
+void RSIStatEwmaItem::addActivity()
 {
-    QBitArray *array = RSIGlobals::instance()->usageArray();
-
-    if ( array->testBit( m_begin ) )
-        m_counter > 0 ? --m_counter : m_counter;
-
-    array->clearBit( m_end );
+    m_average = m_decay * m_average + ( 1.0 - m_decay );
+    m_value = QVariant( 100.0 * m_average );
+}
 
-    Q_ASSERT( m_counter <= m_size );
+void RSIStatEwmaItem::addIdle( int seconds )
+{
+    if ( seconds <= 0 )
+        return;
 
-    m_value = QVariant( 100.0 * ( double )( m_counter ) / ( double )( m_size ) );
-    m_begin = ( m_begin + 1 ) % totalarraysize;
-    m_end = ( m_end + 1 ) % totalarraysize;
+    m_average *= seconds == 1 ? m_decay : pow( m_decay, seconds );
+    m_value = QVariant( 100.0 * m_average );
 }
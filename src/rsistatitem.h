@@ -22,12 +22,9 @@
 
 #include <QList>
 #include <QVariant>
-#include <QLabel>
 
 #include "rsiglobals.h"
 
-class QLabel;
-
 /**
  * This class represents one statistic.
  * It consists of a value, a description and a list
@@ -51,8 +48,8 @@ public:
     /** Default destructor. */
     virtual ~RSIStatItem();
 
-    /** Retrieve the item's description in QLabel format. */
-    QLabel *getDescription() const {
+    /** Retrieve the item's description. */
+    QString getDescription() const {
         return m_description;
     }
 
@@ -99,7 +96,7 @@ protected:
     QVariant m_init;
 
 private:
-    QLabel *m_description;
+    QString m_description;
 
     /** Contains a list of RSIStats which depend on *this* item. */
     QList< RSIStat > m_derived;
@@ -109,54 +106,84 @@ private:
 
 /**
  * This is a more extended statistic item.
- * It uses a part of the bit array defined in RSIGlobals, which keeps track per
- * second when the user was active or idle (max. 24 hours).
- * The amount of time recorded by this item is specified with the size
+ * It reads a window of the activity timeline in RSIGlobals, which keeps track
+ * per second when the user was active or idle (max. 24 hours).
+ * The amount of time covered by this item is specified with the size
  * attribute in the constructor.
  *
  * @author Bram Schoenmakers <bramschoenmakers@kde.nl>
  * @see RSIGlobals
  */
-class RSIStatBitArrayItem : public RSIStatItem
+class RSIStatActivityItem : public RSIStatItem
 {
 public:
     /**
-     * Constructor of a bit array item.
+     * Constructor of an activity item.
      * @param description A i18n()'d text representing this statistic's meaning.
      * @param init The initial value of this statistic. Default value is an
      * integer zero.
      * @param size The amount of time this item keeps track of in seconds. Default
      * it keeps track of 24 hours of usage. This value should be never higher than
-     * 86400 seconds.
+     * the horizon of the activity timeline.
      */
-    explicit RSIStatBitArrayItem( const QString &description = QString(), const QVariant &init = QVariant( 0 ), int size = 86400 );
+    explicit RSIStatActivityItem( const QString &description = QString(), const QVariant &init = QVariant( 0 ), int size = 86400 );
 
     /**
      * Destructor.
      */
-    ~RSIStatBitArrayItem();
+    ~RSIStatActivityItem();
+
+    /**
+     * Recalculates the percentage of activity in the last size seconds,
+     * after a second has been added to the activity timeline.
+     */
+    void update();
+
+private:
+    int m_size;
+};
+
+/**
+ * This statistic item keeps an exponentially weighted moving average of the
+ * activity, as a percentage. A second of activity or idleness weighs less
+ * the longer ago it happened; after the time constant passed its weight
+ * dropped to about a third.
+ *
+ * Unlike RSIStatActivityItem it does not need any history, so it can cover
+ * long periods like a day or a week.
+ */
+class RSIStatEwmaItem : public RSIStatItem
+{
+public:
+    /**
+     * Constructor of a moving average item.
+     * @param description A i18n()'d text representing this statistic's meaning.
+     * @param timeConstant The time constant of the average in seconds.
+     */
+    RSIStatEwmaItem( const QString &description, int timeConstant );
 
     /**
-     * Resets the value of this item and the complete usage array
-     * in RSIGlobals.
+     * Destructor.
      */
+    ~RSIStatEwmaItem();
+
     void reset() override;
 
     /**
-     * Updates the value of this item when activity has occurred.
+     * Updates the average with a second of activity.
      */
-    void setActivity();
+    void addActivity();
 
     /**
-     * Updates the value of this item when the user was idle.
+     * Updates the average with @p seconds seconds of idleness.
+     * Longer periods are handled at once, for example when the computer
+     * was suspended.
      */
-    void setIdle();
+    void addIdle( int seconds = 1 );
 
 private:
-    int m_size;
-    int m_counter;
-    int m_begin;
-    int m_end;
+    double m_decay;
+    double m_average;
 };
 
 #endif
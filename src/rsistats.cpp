@@ -18,6 +18,9 @@
 
 #include "rsistats.h"
 #include "rsistatitem.h"
+#include "rsistatsmodel.h"
+
+#include <atomic>
 
 #include <QDateTime>
 #include <QLocale>
@@ -25,7 +28,8 @@
 #include <KLocalizedString>
 
 RSIStats::RSIStats()
-        : m_doUpdates( false )
+        : m_histogramsChanged( true ), m_lastIdleSeconds( 0 ), m_streakSeconds( 0 ),
+          m_streakLength( 0 ), m_model( 0 )
 {
     m_statistics.insert( TOTAL_TIME,
                          new RSIStatItem( i18n( "Total recorded time" ) ) );
@@ -37,32 +41,51 @@ RSIStats::RSIStats()
     m_statistics[ACTIVITY]->addDerivedItem( ACTIVITY_PERC_MINUTE );
     m_statistics[ACTIVITY]->addDerivedItem( ACTIVITY_PERC_HOUR );
     m_statistics[ACTIVITY]->addDerivedItem( ACTIVITY_PERC_6HOUR );
+    m_statistics[ACTIVITY]->addDerivedItem( ACTIVITY_EWMA_HOUR );
+    m_statistics[ACTIVITY]->addDerivedItem( ACTIVITY_EWMA_DAY );
+    m_statistics[ACTIVITY]->addDerivedItem( ACTIVITY_EWMA_WEEK );
 
     m_statistics.insert( IDLENESS,
                          new RSIStatItem( i18n( "Total time being idle" ) ) );
     m_statistics[IDLENESS]->addDerivedItem( ACTIVITY_PERC_MINUTE );
     m_statistics[IDLENESS]->addDerivedItem( ACTIVITY_PERC_HOUR );
     m_statistics[IDLENESS]->addDerivedItem( ACTIVITY_PERC_6HOUR );
+    m_statistics[IDLENESS]->addDerivedItem( ACTIVITY_EWMA_HOUR );
+    m_statistics[IDLENESS]->addDerivedItem( ACTIVITY_EWMA_DAY );
+    m_statistics[IDLENESS]->addDerivedItem( ACTIVITY_EWMA_WEEK );
 
     m_statistics.insert( ACTIVITY_PERC,
                          new RSIStatItem( i18n( "Percentage of activity" ), 0 ) );
 
     m_statistics.insert( ACTIVITY_PERC_MINUTE,
-                         new RSIStatBitArrayItem( i18n( "Percentage of activity last minute" ),
+                         new RSIStatActivityItem( i18n( "Percentage of activity last minute" ),
                                                   QVariant( 0 ), 60 ) );
     m_statistics.insert( ACTIVITY_PERC_HOUR,
-                         new RSIStatBitArrayItem( i18n( "Percentage of activity last hour" ),
+                         new RSIStatActivityItem( i18n( "Percentage of activity last hour" ),
                                                   QVariant( 0 ), 3600 ) );
     m_statistics.insert( ACTIVITY_PERC_6HOUR,
-                         new RSIStatBitArrayItem( i18n( "Percentage of activity last 6 hours" ),
+                         new RSIStatActivityItem( i18n( "Percentage of activity last 6 hours" ),
                                                   QVariant( 0 ), 6 * 3600 ) );
 
+    m_statistics.insert( ACTIVITY_EWMA_HOUR,
+                         new RSIStatEwmaItem( i18n( "Average activity, hourly trend" ), 3600 ) );
+    m_statistics.insert( ACTIVITY_EWMA_DAY,
+                         new RSIStatEwmaItem( i18n( "Average activity, daily trend" ), 24 * 3600 ) );
+    m_statistics.insert( ACTIVITY_EWMA_WEEK,
+                         new RSIStatEwmaItem( i18n( "Average activity, weekly trend" ), 7 * 24 * 3600 ) );
+
     m_statistics.insert( MAX_IDLENESS,
                          new RSIStatItem( i18n( "Maximum idle period" ) ) );
     m_statistics[MAX_IDLENESS]->addDerivedItem( IDLENESS );
 
     m_statistics.insert( CURRENT_IDLE_TIME,
                          new RSIStatItem( i18n( "Current idle period" ) ) );
+    m_statistics[CURRENT_IDLE_TIME]->addDerivedItem( IDLE_PERIOD_P50 );
+    m_statistics[CURRENT_IDLE_TIME]->addDerivedItem( IDLE_PERIOD_P90 );
+    m_statistics[CURRENT_IDLE_TIME]->addDerivedItem( IDLE_PERIOD_P99 );
+    m_statistics[CURRENT_IDLE_TIME]->addDerivedItem( WORK_STREAK_P50 );
+    m_statistics[CURRENT_IDLE_TIME]->addDerivedItem( WORK_STREAK_P90 );
+    m_statistics[CURRENT_IDLE_TIME]->addDerivedItem( WORK_STREAK_P99 );
 
     m_statistics.insert( IDLENESS_CAUSED_SKIP_TINY,
                          new RSIStatItem( i18n( "Number of skipped short breaks (idle)" ) ) );
@@ -103,14 +126,19 @@ RSIStats::RSIStats()
 
     m_statistics.insert( PAUSE_SCORE, new RSIStatItem( i18n( "Pause score" ), 100 ) );
 
-    // initialise labels
-    for ( int i = 0; i < STAT_COUNT; ++i ) {
-        QLabel *l = new QLabel( 0 );
-        const QString whatsThis = getWhatsThisText( static_cast<RSIStat>(i) );
-        l->setWhatsThis( whatsThis );
-        m_statistics[i]->getDescription()->setWhatsThis( whatsThis );
-        m_labels << l;
-    }
+    m_statistics.insert( IDLE_PERIOD_P50,
+                         new RSIStatItem( i18n( "Median idle period" ) ) );
+    m_statistics.insert( IDLE_PERIOD_P90,
+                         new RSIStatItem( i18n( "Idle period, 90th percentile" ) ) );
+    m_statistics.insert( IDLE_PERIOD_P99,
+                         new RSIStatItem( i18n( "Idle period, 99th percentile" ) ) );
+
+    m_statistics.insert( WORK_STREAK_P50,
+                         new RSIStatItem( i18n( "Median work streak" ) ) );
+    m_statistics.insert( WORK_STREAK_P90,
+                         new RSIStatItem( i18n( "Work streak, 90th percentile" ) ) );
+    m_statistics.insert( WORK_STREAK_P99,
+                         new RSIStatItem( i18n( "Work streak, 99th percentile" ) ) );
 
     // initialise statistics
     reset();
@@ -118,22 +146,46 @@ RSIStats::RSIStats()
 
 RSIStats::~RSIStats()
 {
-    qDeleteAll(m_labels);
-
-    for ( int i = 0; i < STAT_COUNT; ++i ) {
-        RSIStatItem *item = m_statistics[i];
-        QLabel *l = item->getDescription();
-        delete l;
-        delete item;
-    }
+    delete m_model;
+    qDeleteAll( m_statistics );
 }
 
 void RSIStats::reset()
 {
-    for ( int i = 0; i < STAT_COUNT; ++i ) {
+    for ( int i = 0; i < STAT_COUNT; ++i )
         m_statistics[ i ]->reset();
-        updateStat( static_cast<RSIStat>(i), /* update derived stats */ false );
+
+    RSIGlobals::instance()->resetUsage();
+    m_idlePeriods.reset();
+    m_workStreaks.reset();
+    m_histogramsChanged = true;
+    m_lastIdleSeconds = 0;
+    m_streakSeconds = 0;
+    m_streakLength = 0;
+
+    publish();
+}
+
+void RSIStats::publish()
+{
+    QVector<QVariant> values( STAT_COUNT );
+    for ( int i = 0; i < STAT_COUNT; ++i )
+        values[ i ] = m_statistics[ i ]->getValue();
+
+    if ( m_histogramsChanged ) {
+        m_publishedIdlePeriods = std::make_shared<const RSIHistogram>( m_idlePeriods );
+        m_publishedWorkStreaks = std::make_shared<const RSIHistogram>( m_workStreaks );
+        m_histogramsChanged = false;
     }
+
+    std::atomic_store( &m_snapshot,
+                       std::shared_ptr<const RSIStatsSnapshot>(
+                           new RSIStatsSnapshot( values, m_publishedIdlePeriods, m_publishedWorkStreaks ) ) );
+}
+
+std::shared_ptr<const RSIStatsSnapshot> RSIStats::snapshot() const
+{
+    return std::atomic_load( &m_snapshot );
 }
 
 void RSIStats::increaseStat( RSIStat stat, int delta )
@@ -166,8 +218,58 @@ void RSIStats::setStat( RSIStat stat, const QVariant &val, bool ifmax )
     updateStat( stat );
 }
 
+void RSIStats::addIdleGap( int seconds )
+{
+    const RSIStat averages[] = { ACTIVITY_EWMA_HOUR, ACTIVITY_EWMA_DAY, ACTIVITY_EWMA_WEEK };
+    for ( RSIStat stat : averages ) {
+        static_cast<RSIStatEwmaItem *>( m_statistics[ stat ] )->addIdle( seconds );
+        updateStat( stat );
+    }
+}
+
+bool RSIStats::recordIdleTime( int idleSeconds )
+{
+    const int threshold = RSIGlobals::instance()->intervals()[TINY_BREAK_THRESHOLD];
+    bool recorded = false;
+
+    if ( idleSeconds == 0 ) {
+        // An idle period just ended.
+        if ( m_lastIdleSeconds > 0 ) {
+            m_idlePeriods.record( m_lastIdleSeconds );
+            recorded = true;
+        }
+
+        ++m_streakSeconds;
+        m_streakLength = m_streakSeconds;
+    } else if ( m_streakLength > 0 ) {
+        if ( idleSeconds >= threshold ) {
+            // Idle long enough to call it a rest, the streak is over. The
+            // idle seconds at the end of the streak do not count.
+            m_workStreaks.record( m_streakLength );
+            m_streakSeconds = 0;
+            m_streakLength = 0;
+            recorded = true;
+        } else {
+            ++m_streakSeconds;
+        }
+    }
+
+    m_lastIdleSeconds = idleSeconds;
+    m_histogramsChanged = m_histogramsChanged || recorded;
+    return recorded;
+}
+
 void RSIStats::updateDependentStats( RSIStat stat )
 {
+    // Percentiles only need to be calculated when a histogram changed.
+    const bool histogramsChanged = stat == CURRENT_IDLE_TIME &&
+                                   recordIdleTime( m_statistics[ CURRENT_IDLE_TIME ]->getValue().toInt() );
+
+    // Every second is either counted as ACTIVITY or as IDLENESS, the activity
+    // items read the timeline after it has been extended.
+    if ( stat == ACTIVITY || stat == IDLENESS )
+        RSIGlobals::instance()->activityTimeline()->append( stat == ACTIVITY );
+
     const QList<RSIStat> &stats = m_statistics[ stat ]->getDerivedItems();
     for ( int i = 0 ; i < stats.count(); ++i ) {
         RSIStat it = stats.at( i );
@@ -224,10 +326,19 @@ void RSIStats::updateDependentStats( RSIStat stat )
         case ACTIVITY_PERC_MINUTE:
         case ACTIVITY_PERC_HOUR:
         case ACTIVITY_PERC_6HOUR: {
+            static_cast<RSIStatActivityItem *>( m_statistics[it] )->update();
+
+            updateStat( it );
+            break;
+        }
+
+        case ACTIVITY_EWMA_HOUR:
+        case ACTIVITY_EWMA_DAY:
+        case ACTIVITY_EWMA_WEEK: {
             if ( stat == ACTIVITY )
-                static_cast<RSIStatBitArrayItem *>( m_statistics[it] )->setActivity();
+                static_cast<RSIStatEwmaItem *>( m_statistics[it] )->addActivity();
             else
-                static_cast<RSIStatBitArrayItem *>( m_statistics[it] )->setIdle();
+                static_cast<RSIStatEwmaItem *>( m_statistics[it] )->addIdle();
 
             updateStat( it );
             break;
@@ -243,196 +354,53 @@ void RSIStats::updateDependentStats( RSIStat stat )
             break;
         }
 
+        case IDLE_PERIOD_P50:
+        case IDLE_PERIOD_P90:
+        case IDLE_PERIOD_P99:
+        case WORK_STREAK_P50:
+        case WORK_STREAK_P90:
+        case WORK_STREAK_P99: {
+            if ( !histogramsChanged )
+                break;
+
+            const bool idle = it == IDLE_PERIOD_P50 || it == IDLE_PERIOD_P90 || it == IDLE_PERIOD_P99;
+            const RSIHistogram &histogram = idle ? m_idlePeriods : m_workStreaks;
+
+            double percent = 50;
+            if ( it == IDLE_PERIOD_P90 || it == WORK_STREAK_P90 )
+                percent = 90;
+            else if ( it == IDLE_PERIOD_P99 || it == WORK_STREAK_P99 )
+                percent = 99;
+
+            m_statistics[ it ]->setValue( histogram.percentile( percent ) );
+            break;
+        }
+
         default:
             ;// nada
         }
     }
 }
 
-void RSIStats::updateStat( RSIStat stat, bool updateDerived )
-{
-    if ( updateDerived )
-        updateDependentStats( stat );
-
-    if ( m_doUpdates )
-        updateLabel( stat );
-}
-
-void RSIStats::updateLabel( RSIStat stat )
-{
-    QLabel *l = m_labels[ stat ];
-    QColor c;
-    double v;
-
-    switch ( stat ) {
-        // integer values representing a time
-    case TOTAL_TIME:
-    case ACTIVITY:
-    case IDLENESS:
-    case MAX_IDLENESS:
-    case CURRENT_IDLE_TIME:
-        l->setText( RSIGlobals::instance()->formatSeconds(
-                        m_statistics[ stat ]->getValue().toInt() ) );
-        break;
-
-        // plain integer values
-    case TINY_BREAKS:
-    case TINY_BREAKS_SKIPPED:
-    case TINY_BREAKS_POSTPONED:
-    case IDLENESS_CAUSED_SKIP_TINY:
-    case BIG_BREAKS:
-    case BIG_BREAKS_SKIPPED:
-    case BIG_BREAKS_POSTPONED:
-    case IDLENESS_CAUSED_SKIP_BIG:
-        l->setText( QString::number(
-                        m_statistics[ stat ]->getValue().toInt() ) );
-        break;
-
-        // doubles
-    case PAUSE_SCORE:
-        v = m_statistics[ stat ]->getValue().toDouble();
-        setColor( stat, QColor(( int )( 255 - 2.55 * v ), ( int )( 1.60 * v ), 0 ) );
-        l->setText( QString::number(
-                        m_statistics[ stat ]->getValue().toDouble(), 'f', 1 ) );
-        break;
-    case ACTIVITY_PERC:
-    case ACTIVITY_PERC_MINUTE:
-    case ACTIVITY_PERC_HOUR:
-    case ACTIVITY_PERC_6HOUR:
-        v = m_statistics[stat]->getValue().toDouble();
-        setColor( stat, QColor(( int )( 2.55 * v ), ( int )( 160 - 1.60 * v ), 0 ) );
-        l->setText( QString::number(
-                        m_statistics[ stat ]->getValue().toDouble(), 'f', 1 ) );
-        break;
-
-        // datetimes
-    case LAST_BIG_BREAK:
-    case LAST_TINY_BREAK: {
-        QTime when( m_statistics[ stat ]->getValue().toTime() );
-        when.isValid() ? l->setText( when.toString() )
-        : l->clear();
-        break;
-    }
-
-    default:
-        ; // nada
-    }
-
-    // some stats need a %
-    if ( stat == PAUSE_SCORE || stat == ACTIVITY_PERC || stat == ACTIVITY_PERC_MINUTE ||
-            stat == ACTIVITY_PERC_HOUR || stat == ACTIVITY_PERC_6HOUR )
-        l->setText( l->text() + '%' );
-}
-
-void RSIStats::updateLabels()
+void RSIStats::updateStat( RSIStat stat )
 {
-    if ( !m_doUpdates )
-        return;
-
-    for ( int i = 0; i < STAT_COUNT; ++i ) {
-        updateLabel( static_cast<RSIStat>(i) );
-    }
+    updateDependentStats( stat );
 }
 
 QVariant RSIStats::getStat( RSIStat stat ) const
 {
-    return m_statistics[ stat ]->getValue();
-}
-
-QLabel *RSIStats::getLabel( RSIStat stat ) const
-{
-    return m_labels[ stat ];
+    return snapshot()->value( stat );
 }
 
-QLabel *RSIStats::getDescription( RSIStat stat ) const
+QString RSIStats::getDescription( RSIStat stat ) const
 {
     return m_statistics[stat]->getDescription();
 }
 
-QString RSIStats::getWhatsThisText( RSIStat stat ) const
+RSIStatsModel *RSIStats::model()
 {
-    switch ( stat ) {
-    case TOTAL_TIME:
-        return i18n( "This is the total time RSIBreak has been running." );
-    case ACTIVITY:
-        return i18n( "This is the total amount of time you used the "
-                     "keyboard or mouse." );
-    case IDLENESS:
-        return i18n( "This is the total amount of time you did not use "
-                     "the keyboard or mouse." );
-    case ACTIVITY_PERC:
-        return i18n( "This is a percentage of activity, based on the "
-                     "periods of activity vs. the total time RSIBreak has been running. "
-                     "The color indicates the level of your activity. When the color is "
-                     "close to full red it is recommended you lower your work pace." );
-    case MAX_IDLENESS:
-        return i18n( "This is the longest period of inactivity measured "
-                     "while RSIBreak has been running." );
-    case TINY_BREAKS:
-        return i18n( "This is the total number of short breaks" );
-    case LAST_TINY_BREAK:
-        return i18n( "This is the time of the last finished short break. "
-                     "The color of this text gradually turns from green to red, "
-                     "indicating when you can expect the next tiny break." );
-    case TINY_BREAKS_SKIPPED:
-        return i18n( "This is the total number of short breaks "
-                     "which you skipped." );
-    case TINY_BREAKS_POSTPONED:
-        return i18n( "This is the total number of short breaks "
-                     "which you postponed." );
-    case IDLENESS_CAUSED_SKIP_TINY:
-        return i18n( "This is the total number of short breaks "
-                     "which were skipped because you were idle." );
-    case BIG_BREAKS:
-        return i18n( "This is the total number of long breaks." );
-    case LAST_BIG_BREAK:
-        return i18n( "This is the time of the last finished long break."
-                     "The color of this text gradually turns from green to red,"
-                     "indicating when you can expect the next big break." );
-    case BIG_BREAKS_SKIPPED:
-        return i18n( "This is the total number of long breaks "
-                     "which you skipped." );
-    case BIG_BREAKS_POSTPONED:
-        return i18n( "This is the total number of long breaks "
-                     "which you postponed." );
-    case IDLENESS_CAUSED_SKIP_BIG:
-        return i18n( "This is the total number of long breaks "
-                     "which were skipped because you were idle." );
-    case PAUSE_SCORE:
-        return i18n( "This is an indication of how well you behaved "
-                     "with the breaks. It decreases every time you skip a break." );
-    case CURRENT_IDLE_TIME:
-        return i18n( "This is the current idle time." );
-    case ACTIVITY_PERC_MINUTE:
-        return i18n( "This is a percentage of activity during the last minute. "
-                     "The color indicates the level of your activity. When the color is "
-                     "close to full red it is recommended you lower your work pace." );
-    case ACTIVITY_PERC_HOUR:
-        return i18n( "This is a percentage of activity during the last hour. "
-                     "The color indicates the level of your activity. When the color is "
-                     "close to full red it is recommended you lower your work pace." );
-    case ACTIVITY_PERC_6HOUR:
-        return i18n( "This is a percentage of activity during the last 6 hours. "
-                     "The color indicates the level of your activity. When the color is "
-                     "close to full red it is recommended you lower your work pace." );
-    default:
-        ;
-    }
-
-    return QString();
-}
+    if ( !m_model )
+        m_model = new RSIStatsModel( this );
 
-void RSIStats::setColor( RSIStat stat, const QColor &color )
-{
-    QPalette normal;
-    normal.setColor( QPalette::Active, QPalette::WindowText, color );
-    m_statistics[ stat ]->getDescription()->setPalette( normal );
-    m_labels[ stat ]->setPalette( normal );
-}
-
-void RSIStats::doUpdates( bool b )
-{
-    m_doUpdates = b;
-    if ( m_doUpdates )
-        updateLabels();
+    return m_model;
 }
@@ -21,17 +21,59 @@
 #define RSISTATS_H
 
 #include "rsiglobals.h"
+#include "rsihistogram.h"
 
-class QLabel;
+#include <memory>
+
+#include <QVariant>
+#include <QVector>
 
 class RSIStatItem;
+class RSIStatsModel;
+
+/**
+  An immutable copy of the values of all statistics. The RSITimer publishes
+  a new snapshot when it has finished updating the statistics, readers in
+  other threads (the GUI, D-Bus) only ever see complete snapshots.
+
+  @see RSIStats::snapshot()
+*/
+class RSIStatsSnapshot
+{
+public:
+    RSIStatsSnapshot( const QVector<QVariant> &values,
+                      const std::shared_ptr<const RSIHistogram> &idlePeriods,
+                      const std::shared_ptr<const RSIHistogram> &workStreaks )
+        : m_values( values ), m_idlePeriods( idlePeriods ), m_workStreaks( workStreaks ) {}
+
+    /** Returns the value of @p stat at the moment this snapshot was taken. */
+    QVariant value( RSIStat stat ) const {
+        return m_values.at( stat );
+    }
+
+    /** Returns the histogram of the lengths of idle periods. */
+    const RSIHistogram &idlePeriods() const {
+        return *m_idlePeriods;
+    }
+
+    /** Returns the histogram of the lengths of work streaks. */
+    const RSIHistogram &workStreaks() const {
+        return *m_workStreaks;
+    }
+
+private:
+    const QVector<QVariant> m_values;
+    // Shared between snapshots as long as they do not change.
+    const std::shared_ptr<const RSIHistogram> m_idlePeriods;
+    const std::shared_ptr<const RSIHistogram> m_workStreaks;
+};
 
 /**
   This class records all statistics, gathered by the RSITimer.
   To add a stat, you should add an alias to the RSIStat enum, found
   in RSIGlobal. Then, add the statistic to the constructor of this class
-  and to the updateLabel method. Don't forget to add a What's This text as well
-  in the getWhatsThisText() method.
+  and to RSIStatsModel::formattedValue(). Don't forget to add a What's This
+  text as well in RSIStatsModel::whatsThisText().
   If you add a statistic which is calculated from other statistics, don't
   forget to add those statistics as a dependency in the constructor of this
   class. The value of the derived statistic will be calculated in
@@ -39,8 +81,17 @@ class RSIStatItem;
   The last step involves to actually put it in the statistics widget. Use
   the addStat() method there.
 
+  The statistics have a single writer: the RSITimer. Only the timer calls
+  reset(), increaseStat() and setStat(), and calls publish() once it is done
+  with a tick. Everybody else reads the last published snapshot(), so readers
+  never need a lock and never see a half updated set of values.
+
+  This class does not create any widgets, so it can be used without a GUI.
+  Views use the model(), which is only created when it is asked for.
+
   @see RSIGlobals
-  @see RSIStatDialog
+  @see RSIStatsModel
+  @see RSIStatWidget
   @see RSITimer
 */
 class RSIStats
@@ -51,7 +102,10 @@ public:
     /** Default destructor. */
     ~RSIStats();
 
-    /** Sets all statistics to it's initial value. */
+    /**
+     * Sets all statistics to it's initial value and publishes the result.
+     * Only to be called by the writer, the RSITimer.
+     */
     void reset();
 
     /** Increase the value of statistic @p stat with @p delta (default: 1). */
@@ -68,39 +122,35 @@ public:
     void setStat( RSIStat stat, const QVariant &val, bool ifmax = false );
 
     /**
-     * Set the color of a given statistic.
-     * @param stat The statistic in question.
-     * @param color The color in QColor format.
+     * Lets the moving averages of the activity decay over @p seconds seconds
+     * which were not recorded, for example because the computer was
+     * suspended. This is done at once, no matter how long the gap is.
      */
-    void setColor( RSIStat stat, const QColor &color );
-
-    /** Returns a description for the given @p stat. */
-    QLabel *getDescription( RSIStat stat ) const;
+    void addIdleGap( int seconds );
 
     /**
-     * Updates all labels to the current value of their corresponding
-     * statistic.
+     * Makes the current values visible to readers by publishing them as a
+     * new snapshot. The previous snapshot is released as soon as the last
+     * reader holding it lets go.
      */
-    void updateLabels();
+    void publish();
 
-    /** Gets the value given the @p stat.*/
-    QVariant getStat( RSIStat stat ) const;
+    /** Returns the last published snapshot. Safe to call from any thread. */
+    std::shared_ptr<const RSIStatsSnapshot> snapshot() const;
 
-    /** Gets the value of the statistic @p stat in QLabel format. */
-    QLabel *getLabel( RSIStat stat ) const;
+    /** Returns a description for the given @p stat. */
+    QString getDescription( RSIStat stat ) const;
+
+    /** Gets the value given the @p stat from the last published snapshot.*/
+    QVariant getStat( RSIStat stat ) const;
 
     /**
-      This function prevents RSIStats from calls to updateLabel when
-      it's not really needed, e.g. when the widget is not visible.
-      @param b If true, it will update the labels as soon as the stats
-      update.
-    */
-    void doUpdates( bool b );
+     * Returns the table model of the statistics, creating it on first use.
+     * Must be called from the GUI thread.
+     */
+    RSIStatsModel *model();
 
 protected:
-    /** Update the label of given @p stat to it's corresponding value. */
-    void updateLabel( RSIStat stat );
-
     /**
      * Some statistics are calculated based on values of other statistics.
      * This function updates all statistics with @p stat as dependency.
@@ -108,26 +158,38 @@ protected:
     void updateDependentStats( RSIStat stat );
 
     /**
-     * Updates the given statistic.
+     * Updates the statistics derived from the given statistic.
      * @param stat The statistic you've just assigned a value to.
-     * @param updateDerived If true, update the derived statistics when
-     * calling this function.
      */
-    void updateStat( RSIStat stat, bool updateDerived = true );
+    void updateStat( RSIStat stat );
 
     /**
-     * Retrieves What's This? text for a given statistic @p stat.
+     * Keeps track of idle periods and work streaks, given the idle time of
+     * the current tick. A work streak is the time between two rests, a rest
+     * being an idle period of at least the tiny break threshold.
+     * @returns true if a period ended and was added to a histogram.
      */
-    QString getWhatsThisText( RSIStat stat ) const;
+    bool recordIdleTime( int idleSeconds );
 
 private:
     static RSIStats *m_instance;
 
-    bool m_doUpdates;
-
     QVector<RSIStatItem *> m_statistics;
-    /** Contains formatted labels. */
-    QVector<QLabel *> m_labels;
+    /** Only accessed through std::atomic_load() and std::atomic_store(). */
+    std::shared_ptr<const RSIStatsSnapshot> m_snapshot;
+
+    RSIHistogram m_idlePeriods;
+    RSIHistogram m_workStreaks;
+    /** The histograms as last published, copied when they have changed. */
+    std::shared_ptr<const RSIHistogram> m_publishedIdlePeriods;
+    std::shared_ptr<const RSIHistogram> m_publishedWorkStreaks;
+    bool m_histogramsChanged;
+
+    int m_lastIdleSeconds;
+    int m_streakSeconds;
+    int m_streakLength;
+
+    RSIStatsModel *m_model;
 };
 
 #endif // RSISTATS_H
@@ -0,0 +1,281 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsistatsmodel.h"
+#include "rsistats.h"
+
+#include <QBrush>
+#include <QDateTime>
+
+#include <KLocalizedString>
+
+RSIStatsModel::RSIStatsModel( RSIStats *stats, QObject *parent )
+        : QAbstractTableModel( parent ), m_stats( stats ), m_colors( STAT_COUNT )
+{
+    m_snapshot = m_stats->snapshot();
+}
+
+RSIStatsModel::~RSIStatsModel() {}
+
+int RSIStatsModel::rowCount( const QModelIndex &parent ) const
+{
+    return parent.isValid() ? 0 : STAT_COUNT;
+}
+
+int RSIStatsModel::columnCount( const QModelIndex &parent ) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QModelIndex RSIStatsModel::statIndex( RSIStat stat, int column ) const
+{
+    return index( stat, column );
+}
+
+QVariant RSIStatsModel::data( const QModelIndex &index, int role ) const
+{
+    if ( !index.isValid() || index.row() >= STAT_COUNT )
+        return QVariant();
+
+    const RSIStat stat = static_cast<RSIStat>( index.row() );
+
+    switch ( role ) {
+    case Qt::DisplayRole:
+        return index.column() == DescriptionColumn ? m_stats->getDescription( stat )
+                                                   : formattedValue( stat );
+    case Qt::WhatsThisRole:
+        return whatsThisText( stat );
+    case Qt::ForegroundRole: {
+        const QColor c = color( stat );
+        return c.isValid() ? QVariant( QBrush( c ) ) : QVariant();
+    }
+    case ColorRole:
+        return color( stat );
+    case ValueRole:
+        return m_snapshot->value( stat );
+    default:
+        return QVariant();
+    }
+}
+
+void RSIStatsModel::setColor( RSIStat stat, const QColor &color )
+{
+    if ( m_colors[ stat ] == color )
+        return;
+
+    m_colors[ stat ] = color;
+    emit dataChanged( statIndex( stat, DescriptionColumn ), statIndex( stat, ValueColumn ) );
+}
+
+void RSIStatsModel::refresh()
+{
+    const std::shared_ptr<const RSIStatsSnapshot> current = m_stats->snapshot();
+    if ( current == m_snapshot )
+        return;
+
+    const std::shared_ptr<const RSIStatsSnapshot> previous = m_snapshot;
+    m_snapshot = current;
+
+    // Report consecutive ranges of changed rows.
+    int first = -1;
+    for ( int i = 0; i <= STAT_COUNT; ++i ) {
+        const bool changed = i < STAT_COUNT &&
+                             previous->value( static_cast<RSIStat>( i ) ) != current->value( static_cast<RSIStat>( i ) );
+        if ( changed && first < 0 ) {
+            first = i;
+        } else if ( !changed && first >= 0 ) {
+            emit dataChanged( index( first, DescriptionColumn ), index( i - 1, ValueColumn ) );
+            first = -1;
+        }
+    }
+}
+
+QColor RSIStatsModel::color( RSIStat stat ) const
+{
+    double v;
+
+    switch ( stat ) {
+    case PAUSE_SCORE:
+        v = m_snapshot->value( stat ).toDouble();
+        return QColor(( int )( 255 - 2.55 * v ), ( int )( 1.60 * v ), 0 );
+    case ACTIVITY_PERC:
+    case ACTIVITY_PERC_MINUTE:
+    case ACTIVITY_PERC_HOUR:
+    case ACTIVITY_PERC_6HOUR:
+    case ACTIVITY_EWMA_HOUR:
+    case ACTIVITY_EWMA_DAY:
+    case ACTIVITY_EWMA_WEEK:
+        v = m_snapshot->value( stat ).toDouble();
+        return QColor(( int )( 2.55 * v ), ( int )( 160 - 1.60 * v ), 0 );
+    default:
+        return m_colors[ stat ];
+    }
+}
+
+QString RSIStatsModel::formattedValue( RSIStat stat ) const
+{
+    const QVariant value = m_snapshot->value( stat );
+
+    switch ( stat ) {
+        // integer values representing a time
+    case TOTAL_TIME:
+    case ACTIVITY:
+    case IDLENESS:
+    case MAX_IDLENESS:
+    case CURRENT_IDLE_TIME:
+    case IDLE_PERIOD_P50:
+    case IDLE_PERIOD_P90:
+    case IDLE_PERIOD_P99:
+    case WORK_STREAK_P50:
+    case WORK_STREAK_P90:
+    case WORK_STREAK_P99:
+        return RSIGlobals::instance()->formatSeconds( value.toInt() );
+
+        // plain integer values
+    case TINY_BREAKS:
+    case TINY_BREAKS_SKIPPED:
+    case TINY_BREAKS_POSTPONED:
+    case IDLENESS_CAUSED_SKIP_TINY:
+    case BIG_BREAKS:
+    case BIG_BREAKS_SKIPPED:
+    case BIG_BREAKS_POSTPONED:
+    case IDLENESS_CAUSED_SKIP_BIG:
+        return QString::number( value.toInt() );
+
+        // percentages
+    case PAUSE_SCORE:
+    case ACTIVITY_PERC:
+    case ACTIVITY_PERC_MINUTE:
+    case ACTIVITY_PERC_HOUR:
+    case ACTIVITY_PERC_6HOUR:
+    case ACTIVITY_EWMA_HOUR:
+    case ACTIVITY_EWMA_DAY:
+    case ACTIVITY_EWMA_WEEK:
+        return QString::number( value.toDouble(), 'f', 1 ) + '%';
+
+        // datetimes
+    case LAST_BIG_BREAK:
+    case LAST_TINY_BREAK: {
+        const QTime when( value.toTime() );
+        return when.isValid() ? when.toString() : QString();
+    }
+
+    default:
+        return QString();
+    }
+}
+
+QString RSIStatsModel::whatsThisText( RSIStat stat ) const
+{
+    switch ( stat ) {
+    case TOTAL_TIME:
+        return i18n( "This is the total time RSIBreak has been running." );
+    case ACTIVITY:
+        return i18n( "This is the total amount of time you used the "
+                     "keyboard or mouse." );
+    case IDLENESS:
+        return i18n( "This is the total amount of time you did not use "
+                     "the keyboard or mouse." );
+    case ACTIVITY_PERC:
+        return i18n( "This is a percentage of activity, based on the "
+                     "periods of activity vs. the total time RSIBreak has been running. "
+                     "The color indicates the level of your activity. When the color is "
+                     "close to full red it is recommended you lower your work pace." );
+    case MAX_IDLENESS:
+        return i18n( "This is the longest period of inactivity measured "
+                     "while RSIBreak has been running." );
+    case TINY_BREAKS:
+        return i18n( "This is the total number of short breaks" );
+    case LAST_TINY_BREAK:
+        return i18n( "This is the time of the last finished short break. "
+                     "The color of this text gradually turns from green to red, "
+                     "indicating when you can expect the next tiny break." );
+    case TINY_BREAKS_SKIPPED:
+        return i18n( "This is the total number of short breaks "
+                     "which you skipped." );
+    case TINY_BREAKS_POSTPONED:
+        return i18n( "This is the total number of short breaks "
+                     "which you postponed." );
+    case IDLENESS_CAUSED_SKIP_TINY:
+        return i18n( "This is the total number of short breaks "
+                     "which were skipped because you were idle." );
+    case BIG_BREAKS:
+        return i18n( "This is the total number of long breaks." );
+    case LAST_BIG_BREAK:
+        return i18n( "This is the time of the last finished long break."
+                     "The color of this text gradually turns from green to red,"
+                     "indicating when you can expect the next big break." );
+    case BIG_BREAKS_SKIPPED:
+        return i18n( "This is the total number of long breaks "
+                     "which you skipped." );
+    case BIG_BREAKS_POSTPONED:
+        return i18n( "This is the total number of long breaks "
+                     "which you postponed." );
+    case IDLENESS_CAUSED_SKIP_BIG:
+        return i18n( "This is the total number of long breaks "
+                     "which were skipped because you were idle." );
+    case PAUSE_SCORE:
+        return i18n( "This is an indication of how well you behaved "
+                     "with the breaks. It decreases every time you skip a break." );
+    case CURRENT_IDLE_TIME:
+        return i18n( "This is the current idle time." );
+    case ACTIVITY_PERC_MINUTE:
+        return i18n( "This is a percentage of activity during the last minute. "
+                     "The color indicates the level of your activity. When the color is "
+                     "close to full red it is recommended you lower your work pace." );
+    case ACTIVITY_PERC_HOUR:
+        return i18n( "This is a percentage of activity during the last hour. "
+                     "The color indicates the level of your activity. When the color is "
+                     "close to full red it is recommended you lower your work pace." );
+    case ACTIVITY_PERC_6HOUR:
+        return i18n( "This is a percentage of activity during the last 6 hours. "
+                     "The color indicates the level of your activity. When the color is "
+                     "close to full red it is recommended you lower your work pace." );
+    case IDLE_PERIOD_P50:
+        return i18n( "Half of the periods you did not use the keyboard or mouse "
+                     "were shorter than this." );
+    case IDLE_PERIOD_P90:
+        return i18n( "Nine out of ten periods you did not use the keyboard or mouse "
+                     "were shorter than this." );
+    case IDLE_PERIOD_P99:
+        return i18n( "Only one out of hundred periods you did not use the keyboard "
+                     "or mouse was longer than this." );
+    case WORK_STREAK_P50:
+        return i18n( "Half of the times you worked without resting were shorter "
+                     "than this. A rest is a pause of at least the short break threshold." );
+    case WORK_STREAK_P90:
+        return i18n( "Nine out of ten times you worked without resting were shorter "
+                     "than this. When this gets much longer than the interval between "
+                     "short breaks, you are skipping breaks." );
+    case WORK_STREAK_P99:
+        return i18n( "Only one out of hundred times you worked without resting was "
+                     "longer than this." );
+    case ACTIVITY_EWMA_HOUR:
+        return i18n( "This is your average activity, where the last hour counts "
+                     "most. It changes smoothly, so it shows how busy you have been lately." );
+    case ACTIVITY_EWMA_DAY:
+        return i18n( "This is your average activity, where the last day counts most. "
+                     "Time RSIBreak was not running counts as idle." );
+    case ACTIVITY_EWMA_WEEK:
+        return i18n( "This is your average activity, where the last week counts most. "
+                     "Compare it with the daily trend to see if today was busier "
+                     "than usual." );
+    default:
+        ;
+    }
+
+    return QString();
+}
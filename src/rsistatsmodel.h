@@ -0,0 +1,93 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSISTATSMODEL_H
+#define RSISTATSMODEL_H
+
+#include <QAbstractTableModel>
+#include <QColor>
+#include <QVector>
+
+#include <memory>
+
+#include "rsiglobals.h"
+
+class RSIStats;
+class RSIStatsSnapshot;
+
+/**
+ * Table model for the statistics. There is one row per RSIStat, the first
+ * column contains the description and the second column the value.
+ *
+ * The model shows the snapshots published by RSIStats. Call refresh() to
+ * pick up the latest snapshot, only the changed rows are reported.
+ *
+ * @see RSIStats
+ * @see RSIStatWidget
+ */
+class RSIStatsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        DescriptionColumn = 0,
+        ValueColumn,
+        ColumnCount
+    };
+
+    enum Role {
+        /** The plain value of the statistic, as stored in RSIStats. */
+        ValueRole = Qt::UserRole,
+        /** The color of the statistic as QColor, invalid if it has none. */
+        ColorRole
+    };
+
+    /**
+     * Constructor.
+     * @param stats The statistics to show. Not owned by the model.
+     */
+    explicit RSIStatsModel( RSIStats *stats, QObject *parent = 0 );
+    ~RSIStatsModel();
+
+    int rowCount( const QModelIndex &parent = QModelIndex() ) const override;
+    int columnCount( const QModelIndex &parent = QModelIndex() ) const override;
+    QVariant data( const QModelIndex &index, int role = Qt::DisplayRole ) const override;
+
+    /** Returns the index of @p stat in the given @p column. */
+    QModelIndex statIndex( RSIStat stat, int column = ValueColumn ) const;
+
+    /**
+     * Sets the color of a statistic which does not derive its color from
+     * its own value, like the time of the last breaks.
+     */
+    void setColor( RSIStat stat, const QColor &color );
+
+public slots:
+    /** Reads the last published snapshot and reports what changed. */
+    void refresh();
+
+private:
+    QString formattedValue( RSIStat stat ) const;
+    QColor color( RSIStat stat ) const;
+    QString whatsThisText( RSIStat stat ) const;
+
+    RSIStats *m_stats;
+    std::shared_ptr<const RSIStatsSnapshot> m_snapshot;
+    QVector<QColor> m_colors;
+};
+
+#endif // RSISTATSMODEL_H
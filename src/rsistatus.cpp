@@ -0,0 +1,58 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsistatus.h"
+
+RSIStatus::RSIStatus()
+        : tinyLeft( 0 ), bigLeft( 0 ), breakLeft( 0 ), idleTime( 0 ), suspended( false ),
+          inBreak( false ), nextBreak( "short" )
+{
+}
+
+// The value of a counter as shown: minutes, and seconds in the last one.
+static int shown( int seconds )
+{
+    return seconds > 60 ? 60 + ( seconds + 59 ) / 60 : seconds;
+}
+
+bool RSIStatus::differsVisiblyFrom( const RSIStatus &other ) const
+{
+    return shown( tinyLeft ) != shown( other.tinyLeft )
+           || shown( bigLeft ) != shown( other.bigLeft )
+           || breakLeft != other.breakLeft
+           || suspended != other.suspended
+           || inBreak != other.inBreak
+           || nextBreak != other.nextBreak
+           || icon != other.icon;
+}
+
+QDBusArgument &operator<<( QDBusArgument &argument, const RSIStatus &status )
+{
+    argument.beginStructure();
+    argument << status.tinyLeft << status.bigLeft << status.breakLeft << status.idleTime
+             << status.suspended << status.inBreak << status.nextBreak << status.icon;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>( const QDBusArgument &argument, RSIStatus &status )
+{
+    argument.beginStructure();
+    argument >> status.tinyLeft >> status.bigLeft >> status.breakLeft >> status.idleTime
+             >> status.suspended >> status.inBreak >> status.nextBreak >> status.icon;
+    argument.endStructure();
+    return argument;
+}
@@ -0,0 +1,54 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSISTATUS_H
+#define RSIBREAK_RSISTATUS_H
+
+#include <QDBusArgument>
+#include <QMetaType>
+#include <QString>
+
+/**
+ * Everything a status applet shows, sent over D-Bus as one struct of the
+ * signature (iiiibbss) by RSIObject::status() and StatusChanged.
+ */
+struct RSIStatus {
+    RSIStatus();
+
+    int tinyLeft;       // Seconds until the short break, 0 or less during it.
+    int bigLeft;        // Seconds until the long break, 0 or less during it.
+    int breakLeft;      // Seconds left of the break which is shown, 0 otherwise.
+    int idleTime;       // Seconds the user was idle at the last tick.
+    bool suspended;
+    bool inBreak;
+    QString nextBreak;  // "short" or "long".
+    QString icon;       // The name of the icon in the tray.
+
+    /**
+     * @returns true when a client showing @p other would show something
+     * else for this status. The counters are shown in minutes, only the
+     * last minute counts down in seconds. The idle time is left out, it
+     * changes all the time.
+     */
+    bool differsVisiblyFrom( const RSIStatus &other ) const;
+};
+
+Q_DECLARE_METATYPE( RSIStatus )
+
+QDBusArgument &operator<<( QDBusArgument &argument, const RSIStatus &status );
+const QDBusArgument &operator>>( const QDBusArgument &argument, RSIStatus &status );
+
+#endif //RSIBREAK_RSISTATUS_H
@@ -0,0 +1,146 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsistatusserver.h"
+
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStandardPaths>
+
+RSIStatusServer::RSIStatusServer( QObject *parent )
+        : QObject( parent ), m_maxBuffered( 64 * 1024 ), m_dropped( 0 )
+{
+    m_server = new QLocalServer( this );
+    m_server->setSocketOptions( QLocalServer::UserAccessOption );
+    connect( m_server, &QLocalServer::newConnection, this, &RSIStatusServer::slotNewConnection );
+}
+
+RSIStatusServer::~RSIStatusServer()
+{
+    close();
+}
+
+QString RSIStatusServer::defaultPath()
+{
+    const QString dir = QStandardPaths::writableLocation( QStandardPaths::RuntimeLocation );
+    return dir.isEmpty() ? QString() : dir + "/rsibreak-status";
+}
+
+bool RSIStatusServer::listen( const QString &path )
+{
+    close();
+    if ( path.isEmpty() )
+        return false;
+
+    QLocalServer::removeServer( path );
+    if ( !m_server->listen( path ) ) {
+        qWarning() << "Cannot listen on" << path << ":" << m_server->errorString();
+        return false;
+    }
+    return true;
+}
+
+void RSIStatusServer::close()
+{
+    foreach( QLocalSocket *client, m_clients ) {
+        client->disconnect( this );
+        client->abort();
+        client->deleteLater();
+    }
+    m_clients.clear();
+    m_server->close();
+}
+
+bool RSIStatusServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+QString RSIStatusServer::path() const
+{
+    return m_server->fullServerName();
+}
+
+void RSIStatusServer::setMaxBuffered( qint64 bytes )
+{
+    m_maxBuffered = bytes;
+}
+
+QByteArray RSIStatusServer::toJson( const RSIStatus &status )
+{
+    QJsonObject object;
+    object.insert( "tinyLeft", status.tinyLeft );
+    object.insert( "bigLeft", status.bigLeft );
+    object.insert( "breakLeft", status.breakLeft );
+    object.insert( "idleTime", status.idleTime );
+    object.insert( "suspended", status.suspended );
+    object.insert( "inBreak", status.inBreak );
+    object.insert( "nextBreak", status.nextBreak );
+    object.insert( "icon", status.icon );
+    return QJsonDocument( object ).toJson( QJsonDocument::Compact ) + '\n';
+}
+
+void RSIStatusServer::publish( const RSIStatus &status )
+{
+    m_last = toJson( status );
+
+    // Copy, dropping a client changes the list.
+    const QList<QLocalSocket*> clients = m_clients;
+    foreach( QLocalSocket *client, clients )
+        send( client, m_last );
+}
+
+void RSIStatusServer::slotNewConnection()
+{
+    while ( QLocalSocket *client = m_server->nextPendingConnection() ) {
+        m_clients.append( client );
+        connect( client, &QLocalSocket::disconnected, this, &RSIStatusServer::slotDisconnected );
+        // Nothing is read from the clients, but do not let it pile up.
+        connect( client, &QLocalSocket::readyRead, client, &QLocalSocket::readAll );
+
+        if ( !m_last.isEmpty() )
+            send( client, m_last );
+    }
+}
+
+void RSIStatusServer::slotDisconnected()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket*>( sender() );
+    if ( m_clients.removeOne( client ) )
+        client->deleteLater();
+}
+
+void RSIStatusServer::send( QLocalSocket *client, const QByteArray &line )
+{
+    if ( client->bytesToWrite() + line.size() > m_maxBuffered ) {
+        drop( client );
+        return;
+    }
+    client->write( line );
+}
+
+void RSIStatusServer::drop( QLocalSocket *client )
+{
+    qDebug() << "Dropping a status client which does not keep up";
+    m_clients.removeOne( client );
+    client->disconnect( this );
+    client->abort();
+    client->deleteLater();
+    ++m_dropped;
+}
@@ -0,0 +1,85 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSISTATUSSERVER_H
+#define RSIBREAK_RSISTATUSSERVER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+
+#include "rsistatus.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * Streams the status to status bars over a local socket, one JSON object
+ * per line. A client gets the current status when it connects and a new
+ * line each time it changes.
+ *
+ * Writing never blocks: the lines are buffered and sent from the event
+ * loop. A client which lets more than maxBuffered() bytes pile up is
+ * dropped, so a stuck consumer only costs that much memory.
+ */
+class RSIStatusServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RSIStatusServer( QObject *parent = 0 );
+    ~RSIStatusServer();
+
+    /** @returns rsibreak-status in $XDG_RUNTIME_DIR, empty when there is none. */
+    static QString defaultPath();
+
+    /** Starts listening on @p path, replacing a socket left behind there. */
+    bool listen( const QString &path = defaultPath() );
+
+    /** Stops listening and disconnects all clients. */
+    void close();
+
+    bool isListening() const;
+    QString path() const;
+
+    void setMaxBuffered( qint64 bytes );
+    qint64 maxBuffered() const { return m_maxBuffered; }
+
+    int clients() const { return m_clients.count(); }
+    quint64 dropped() const { return m_dropped; }
+
+    /** @returns @p status as a line of JSON, with the newline. */
+    static QByteArray toJson( const RSIStatus &status );
+
+public slots:
+    void publish( const RSIStatus &status );
+
+private slots:
+    void slotNewConnection();
+    void slotDisconnected();
+
+private:
+    void send( QLocalSocket *client, const QByteArray &line );
+    void drop( QLocalSocket *client );
+
+    QLocalServer*       m_server;
+    QList<QLocalSocket*> m_clients;
+    QByteArray          m_last;
+    qint64              m_maxBuffered;
+    quint64             m_dropped;
+};
+
+#endif //RSIBREAK_RSISTATUSSERVER_H
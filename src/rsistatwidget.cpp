@@ -19,19 +19,24 @@
 
 #include "rsistatwidget.h"
 #include "rsistats.h"
+#include "rsistatsmodel.h"
 
 #include <QGridLayout>
 #include <QGroupBox>
 #include <QLabel>
 #include <QLocale>
 #include <QTime>
+#include <QTimer>
 
 #include <KLocalizedString>
 #include <QFontDatabase>
 
 RSIStatWidget::RSIStatWidget( QWidget *parent )
-        : QWidget( parent )
+        : QWidget( parent ), mDescriptions( STAT_COUNT ), mValues( STAT_COUNT )
 {
+    mModel = RSIGlobals::instance()->stats()->model();
+    connect( mModel, &RSIStatsModel::dataChanged, this, &RSIStatWidget::slotDataChanged );
+
     mGrid = new QGridLayout( this );
 
     QGroupBox *gb = new QGroupBox( i18n( "Time" ), this );
@@ -69,18 +74,48 @@ RSIStatWidget::RSIStatWidget( QWidget *parent )
     addStat( BIG_BREAKS_POSTPONED, subgrid, 3 );
     addStat( IDLENESS_CAUSED_SKIP_BIG, subgrid, 4 );
     mGrid->addWidget( gb, 1, 1 );
+
+    gb = new QGroupBox( i18n( "Idle Periods" ), this );
+    subgrid = new QGridLayout( gb );
+    addStat( IDLE_PERIOD_P50, subgrid, 0 );
+    addStat( IDLE_PERIOD_P90, subgrid, 1 );
+    addStat( IDLE_PERIOD_P99, subgrid, 2 );
+    mGrid->addWidget( gb, 2, 0 );
+
+    gb = new QGroupBox( i18n( "Work Streaks" ), this );
+    subgrid = new QGridLayout( gb );
+    addStat( WORK_STREAK_P50, subgrid, 0 );
+    addStat( WORK_STREAK_P90, subgrid, 1 );
+    addStat( WORK_STREAK_P99, subgrid, 2 );
+    mGrid->addWidget( gb, 2, 1 );
+
+    gb = new QGroupBox( i18n( "Activity Trend" ), this );
+    subgrid = new QGridLayout( gb );
+    addStat( ACTIVITY_EWMA_HOUR, subgrid, 0 );
+    addStat( ACTIVITY_EWMA_DAY, subgrid, 1 );
+    addStat( ACTIVITY_EWMA_WEEK, subgrid, 2 );
+    mGrid->addWidget( gb, 3, 0 );
+
+    mUpdateTimer = new QTimer( this );
+    connect( mUpdateTimer, &QTimer::timeout, mModel, &RSIStatsModel::refresh );
 }
 
 RSIStatWidget::~RSIStatWidget() {}
 
 void RSIStatWidget::addStat( RSIStat stat, QGridLayout *grid, int row )
 {
-    QLabel *l = RSIGlobals::instance()->stats()->getDescription( stat );
-    l->setParent( this );
+    const QString whatsThis =
+        mModel->data( mModel->statIndex( stat ), Qt::WhatsThisRole ).toString();
+
+    QLabel *l = new QLabel( mModel->data( mModel->statIndex( stat, RSIStatsModel::DescriptionColumn ) ).toString(),
+                            grid->parentWidget() );
+    l->setWhatsThis( whatsThis );
+    mDescriptions[ stat ] = l;
 
-    QLabel *m = RSIGlobals::instance()->stats()->getLabel( stat );
-    m->setParent( grid->parentWidget() );
+    QLabel *m = new QLabel( grid->parentWidget() );
     m->setAlignment( Qt::AlignRight );
+    m->setWhatsThis( whatsThis );
+    mValues[ stat ] = m;
 
     grid->addWidget( l, row, 0 );
     grid->addWidget( m, row, 1 );
@@ -93,6 +128,12 @@ void RSIStatWidget::addStat( RSIStat stat, QGridLayout *grid, int row )
     case ACTIVITY:
     case IDLENESS:
     case MAX_IDLENESS:
+    case IDLE_PERIOD_P50:
+    case IDLE_PERIOD_P90:
+    case IDLE_PERIOD_P99:
+    case WORK_STREAK_P50:
+    case WORK_STREAK_P90:
+    case WORK_STREAK_P99:
         width = fm.width( "One one and " +
                           i18nc( "Translate this as the longest plural form. This is used to "
                                  "calculate the width of window", "minutes" ) +
@@ -111,14 +152,41 @@ void RSIStatWidget::addStat( RSIStat stat, QGridLayout *grid, int row )
 
     if ( width > 0 )
         m->setMinimumWidth( width );
+
+    updateStat( stat );
+}
+
+void RSIStatWidget::updateStat( RSIStat stat )
+{
+    QLabel *l = mDescriptions[ stat ];
+    QLabel *m = mValues[ stat ];
+    if ( !l || !m )
+        return;
+
+    m->setText( mModel->data( mModel->statIndex( stat ) ).toString() );
+
+    const QColor color = mModel->data( mModel->statIndex( stat ), RSIStatsModel::ColorRole ).value<QColor>();
+    if ( color.isValid() ) {
+        QPalette normal;
+        normal.setColor( QPalette::Active, QPalette::WindowText, color );
+        l->setPalette( normal );
+        m->setPalette( normal );
+    }
+}
+
+void RSIStatWidget::slotDataChanged( const QModelIndex &topLeft, const QModelIndex &bottomRight )
+{
+    for ( int row = topLeft.row(); row <= bottomRight.row(); ++row )
+        updateStat( static_cast<RSIStat>( row ) );
 }
 
 void RSIStatWidget::showEvent( QShowEvent * )
 {
-    RSIGlobals::instance()->stats()->doUpdates( true );
+    mModel->refresh();
+    mUpdateTimer->start( 1000 );
 }
 
 void RSIStatWidget::hideEvent( QHideEvent * )
 {
-    RSIGlobals::instance()->stats()->doUpdates( false );
+    mUpdateTimer->stop();
 }
@@ -22,8 +22,20 @@
 
 #include "rsiglobals.h"
 
+#include <QWidget>
+
 class QGridLayout;
+class QLabel;
+class QModelIndex;
+class QTimer;
+
+class RSIStatsModel;
 
+/**
+ * Shows the statistics of RSIStatsModel in a few groups of labels. The
+ * labels are only created together with this widget, which is only done
+ * when the user wants to see the statistics.
+ */
 class RSIStatWidget : public QWidget
 {
     Q_OBJECT
@@ -35,8 +47,19 @@ protected:
     void addStat( RSIStat stat, QGridLayout *grid, int row );
     void showEvent( QShowEvent * ) override;
     void hideEvent( QHideEvent * ) override;
+
+private slots:
+    void slotDataChanged( const QModelIndex &topLeft, const QModelIndex &bottomRight );
+
 private:
+    void updateStat( RSIStat stat );
+
     QGridLayout *mGrid;
+    RSIStatsModel *mModel;
+    QVector<QLabel *> mDescriptions;
+    QVector<QLabel *> mValues;
+    /** Refreshes the labels from the published statistics while visible. */
+    QTimer *mUpdateTimer;
 };
 
 #endif
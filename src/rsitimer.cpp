@@ -84,6 +84,7 @@ void RSITimer::hibernationDetector( const int totalIdle )
                  << "Last: " << last
                  << "Current: " << current
                  << "Idle, s: " << totalIdle;
+        RSIGlobals::instance()->stats()->addIdleGap( last.secsTo( current ) );
         resetAfterBreak();
     }
     last = current;
@@ -92,7 +93,6 @@ void RSITimer::hibernationDetector( const int totalIdle )
 int RSITimer::idleTime()
 {
     int totalIdle = m_idleTimeInstance->getIdleTime() / 1000;
-    hibernationDetector( totalIdle );
 
     // TODO Find a modern-desktop way to check if the screensaver is inhibited
     // and disable the timer because we assume you're doing for example a presentation and
@@ -108,6 +108,7 @@ void RSITimer::doBreakNow( const int breakTime, const bool nextBreakIsBig )
     m_popupCounter = nullptr;
     RSIGlobals::instance()->NotifyBreak( true, nextBreakIsBig );
     emit updateWidget( breakTime );
+    RSIGlobals::instance()->activationTrace()->breakEmitted();
     emit breakNow();
 }
 
@@ -156,6 +157,7 @@ void RSITimer::skipBreak()
         RSIGlobals::instance()->stats()->increaseStat( TINY_BREAKS_SKIPPED );
         emit tinyBreakSkipped();
     }
+    RSIGlobals::instance()->stats()->publish();
     resetAfterBreak();
 }
 
@@ -168,9 +170,15 @@ void RSITimer::postponeBreak()
         m_tinyBreakCounter->postpone( m_intervals[POSTPONE_BREAK_INTERVAL] );
         RSIGlobals::instance()->stats()->increaseStat( TINY_BREAKS_POSTPONED );
     }
+    RSIGlobals::instance()->stats()->publish();
     resetAfterBreak();
 }
 
+void RSITimer::slotResetStats()
+{
+    RSIGlobals::instance()->stats()->reset();
+}
+
 void RSITimer::updateConfig( bool doRestart )
 {
     KConfigGroup popupConfig = KSharedConfig::openConfig()->group( "Popup Settings" );
@@ -201,6 +209,7 @@ void RSITimer::timeout()
     }
 
     const int idleSeconds = idleTime(); // idleSeconds == 0 means activity
+    hibernationDetector( idleSeconds );
 
     RSIGlobals::instance()->stats()->increaseStat( TOTAL_TIME );
     RSIGlobals::instance()->stats()->setStat( CURRENT_IDLE_TIME, idleSeconds );
@@ -271,6 +280,7 @@ void RSITimer::timeout()
     default:
         qDebug() << "Reached unexpected state";
     }
+    RSIGlobals::instance()->stats()->publish();
     defaultUpdateToolTip();
 }
 
@@ -96,9 +96,16 @@ public slots:
     */
     void postponeBreak();
 
+    /**
+      Resets all statistics. The timer is the only writer of the statistics,
+      so other components request a reset through this slot.
+    */
+    void slotResetStats();
+
     /**
       Queries X how many seconds the user has been idle. A value of 0
-      means there was activity during the last second.
+      means there was activity during the last second. Does not touch the
+      timers or the statistics, so it is safe to call from any thread.
       @returns The amount of seconds of idling.
     */
     int idleTime();
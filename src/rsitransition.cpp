@@ -0,0 +1,110 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsitransition.h"
+#include "rsiframestats.h"
+#include "rsiglobals.h"
+
+#include <QTimer>
+
+// About 60 frames a second, as long as they fit in the budget.
+static const int frameInterval = 16;
+static const int maximumInterval = 100;
+
+// The percentage of a frame interval a frame may take.
+static const int frameBudget = 25;
+
+RSITransition::RSITransition( QObject *parent )
+        : QObject( parent ), m_stats( RSIGlobals::instance()->frameStats() ),
+          m_duration( 0 ), m_lastFrame( -1 ), m_interval( frameInterval )
+{
+    m_timer = new QTimer( this );
+    m_timer->setTimerType( Qt::PreciseTimer );
+    connect( m_timer, &QTimer::timeout, this, &RSITransition::slotFrame );
+}
+
+void RSITransition::start( int duration )
+{
+    if ( isRunning() )
+        end();
+
+    m_duration = qint64( qMax( duration, 0 ) ) * 1000;
+    m_lastFrame = -1;
+    m_interval = frameInterval;
+    m_clock.start();
+    m_timer->start( m_interval );
+    slotFrame();
+}
+
+void RSITransition::stop()
+{
+    if ( isRunning() )
+        end();
+}
+
+bool RSITransition::isRunning() const
+{
+    return m_timer->isActive();
+}
+
+void RSITransition::setStats( RSIFrameStats *stats )
+{
+    m_stats = stats;
+}
+
+void RSITransition::end()
+{
+    m_timer->stop();
+    if ( m_stats )
+        m_stats->recordTransition( m_clock.nsecsElapsed() / 1000 );
+}
+
+void RSITransition::slotFrame()
+{
+    const qint64 elapsed = m_clock.nsecsElapsed() / 1000;
+    const qint64 frameTime = qint64( m_interval ) * 1000;
+
+    // The frames which should have been drawn since the last one.
+    int dropped = 0;
+    if ( m_lastFrame >= 0 )
+        dropped = qMax( 0, int( ( elapsed - m_lastFrame + frameTime / 2 ) / frameTime ) - 1 );
+    m_lastFrame = elapsed;
+
+    const qreal progress = m_duration > 0 ? qMin( qreal( 1 ), qreal( elapsed ) / m_duration ) : 1;
+
+    QElapsedTimer render;
+    render.start();
+    emit frame( progress );
+    const qint64 renderTime = render.nsecsElapsed() / 1000;
+
+    if ( m_stats )
+        m_stats->recordFrame( renderTime, dropped );
+
+    // Stopped while drawing the frame.
+    if ( !isRunning() )
+        return;
+
+    if ( progress >= 1 ) {
+        end();
+        emit finished();
+        return;
+    }
+
+    if ( renderTime * 100 > frameTime * frameBudget && m_interval < maximumInterval ) {
+        m_interval = qMin( m_interval * 2, maximumInterval );
+        m_timer->setInterval( m_interval );
+    }
+}
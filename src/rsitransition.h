@@ -0,0 +1,77 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSITRANSITION_H
+#define RSIBREAK_RSITRANSITION_H
+
+#include <QElapsedTimer>
+#include <QObject>
+
+class QTimer;
+class RSIFrameStats;
+
+/**
+ * Drives a fade or a cross-fade. The progress follows the clock and not
+ * the frames, so a frame which comes late skips the ones it missed instead
+ * of slowing the transition down. When a frame takes more than its share
+ * of the frame interval the frame rate is halved, down to 10 frames a
+ * second.
+ *
+ * The time spent on every frame is recorded in RSIFrameStats.
+ */
+class RSITransition : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RSITransition( QObject *parent = 0 );
+
+    /**
+     * Starts a transition of @p duration milliseconds, the first frame is
+     * drawn right away. A running transition starts over.
+     */
+    void start( int duration );
+
+    /** Stops the transition without drawing its last frame. */
+    void stop();
+
+    bool isRunning() const;
+
+    /** Records the frame times in @p stats, 0 to not record them. */
+    void setStats( RSIFrameStats *stats );
+
+signals:
+    /** Draw the frame at @p progress, from 0 to 1. The last one is at 1. */
+    void frame( qreal progress );
+
+    /** The last frame was drawn. */
+    void finished();
+
+private slots:
+    void slotFrame();
+
+private:
+    void end();
+
+    QTimer*         m_timer;
+    QElapsedTimer   m_clock;
+    RSIFrameStats*  m_stats;
+    qint64          m_duration;
+    qint64          m_lastFrame;
+    int             m_interval;
+};
+
+#endif //RSIBREAK_RSITRANSITION_H
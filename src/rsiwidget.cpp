@@ -28,9 +28,15 @@
 #include "rsidock.h"
 #include "rsirelaxpopup.h"
 #include "rsiglobals.h"
+#include "rsidbuscall.h"
+#include "rsinotifier.h"
+#include "rsistats.h"
+#include "rsistatusserver.h"
 
+#include <QApplication>
 #include <QDebug>
 #include <QDesktopWidget>
+#include <QDir>
 #include <QPainter>
 #include <QTimer>
 
@@ -38,7 +44,8 @@
 #include <KMessageBox>
 #include <KIconLoader>
 #include <KNotification>
-#include <QDBusInterface>
+#include <QDBusConnection>
+#include <QDBusMetaType>
 #include <QTemporaryFile>
 #include <KConfigGroup>
 #include <KSharedConfig>
@@ -55,6 +62,13 @@ RSIObject::RSIObject( QWidget *parent ) : QObject( parent )
     m_tray = new RSIDock( this );
     m_tray->setIconByName( "rsibreak0" );
 
+    m_lockCall = new RSIDBusCall( "org.freedesktop.ScreenSaver", "/ScreenSaver",
+                                  "org.freedesktop.ScreenSaver", "Lock", this );
+
+    m_statusServer = new RSIStatusServer( this );
+    connect(this, &RSIObject::StatusChanged, m_statusServer, &RSIStatusServer::publish);
+
+    qDBusRegisterMetaType<RSIStatus>();
     new RsiwidgetAdaptor( this );
     QDBusConnection dbus = QDBusConnection::sessionBus();
     dbus.registerObject( "/rsibreak", this );
@@ -78,7 +92,7 @@ RSIObject::RSIObject( QWidget *parent ) : QObject( parent )
 
 RSIObject::~RSIObject()
 {
-    delete m_effect;
+    qDeleteAll( m_effects );
     delete RSIGlobals::instance();
     if (m_timer != nullptr) {
         m_timer->quit();
@@ -102,32 +116,103 @@ void RSIObject::slotWelcome()
 void RSIObject::minimize()
 {
     m_effect->deactivate();
+    m_effect->trimMemory();
+    m_preparation.reset();
+    m_status.breakLeft = 0;
+    updateStatus();
 }
 
 void RSIObject::maximize()
 {
+    RSIActivationTrace *trace = RSIGlobals::instance()->activationTrace();
+    trace->begin( QApplication::desktop()->screenCount() );
+    m_preparation.breakStarted();
     m_effect->activate();
+    trace->mark( RSIActivationTrace::Activated );
 }
 
 void RSIObject::slotLock()
 {
     m_effect->deactivate();
+    m_effect->trimMemory();
+    m_preparation.reset();
+    m_status.breakLeft = 0;
+    updateStatus();
     m_timer->slotLock();
 
-    QDBusInterface lock( "org.freedesktop.ScreenSaver", "/ScreenSaver",
-                         "org.freedesktop.ScreenSaver" );
-    lock.call( "Lock" );
+    m_lockCall->call();
 }
 
 void RSIObject::setCounters( int timeleft )
 {
     if ( timeleft > 0 ) {
+        m_preparation.breakStarted();
         m_effect->setLabel( KFormat().formatSpelloutDuration( timeleft * 1000 ) );
     } else if ( m_timer->isSuspended() ) {
         m_effect->setLabel( i18n( "Suspended" ) );
     } else {
         m_effect->setLabel( QString() );
     }
+
+    m_status.breakLeft = qMax( timeleft, 0 );
+    updateStatus();
+}
+
+void RSIObject::prepareBreak( int tinyLeft, int bigLeft )
+{
+    // Get the effect ready shortly before the break, so showing it is quick,
+    // and let go of it again when the break was skipped by being idle.
+    switch ( m_preparation.update( tinyLeft, bigLeft ) ) {
+    case RSIBreakPreparation::Prepare:
+        m_effect->prepare();
+        break;
+    case RSIBreakPreparation::Release:
+        m_effect->trimMemory();
+        break;
+    case RSIBreakPreparation::Nothing:
+        break;
+    }
+}
+
+void RSIObject::breakSuggested( int breakLeft )
+{
+    if ( breakLeft > 0 )
+        m_preparation.breakStarted();
+}
+
+void RSIObject::updateCounters( int tinyLeft, int bigLeft )
+{
+    m_status.tinyLeft = tinyLeft;
+    m_status.bigLeft = bigLeft;
+    updateStatus();
+}
+
+void RSIObject::updateStatus()
+{
+    m_status.suspended = m_timer != nullptr && m_timer->isSuspended();
+    m_status.inBreak = m_status.breakLeft > 0;
+    m_status.nextBreak = m_status.bigLeft <= m_status.tinyLeft ? "long" : "short";
+    m_status.icon = m_currentIcon;
+
+    if ( !m_status.differsVisiblyFrom( m_sentStatus ) )
+        return;
+
+    m_sentStatus = m_status;
+    emit StatusChanged( status() );
+}
+
+RSIStatus RSIObject::status()
+{
+    RSIStatus status = m_status;
+    status.idleTime = idleTime();
+    return status;
+}
+
+int RSIObject::idleTime()
+{
+    // The timer thread is the only writer of the statistics, read what it
+    // published instead of asking it.
+    return RSIGlobals::instance()->stats()->getStat( CURRENT_IDLE_TIME ).toInt();
 }
 
 void RSIObject::updateIdleAvg( double idleAvg )
@@ -153,6 +238,7 @@ void RSIObject::setIcon( int level )
         m_tray->setIconByName( newIcon );
         m_tray->setToolTipIconByName( newIcon );
         m_currentIcon = newIcon;
+        updateStatus();
     }
 }
 
@@ -185,9 +271,12 @@ void RSIObject::configureTimer()
     connect(m_timer, &RSITimer::breakNow, this, &RSIObject::maximize, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::updateWidget, this, &RSIObject::setCounters, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::updateToolTip, m_tray, &RSIDock::setCounters, Qt::QueuedConnection );
+    connect(m_timer, &RSITimer::updateToolTip, this, &RSIObject::prepareBreak, Qt::QueuedConnection );
+    connect(m_timer, &RSITimer::updateToolTip, this, &RSIObject::updateCounters, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::updateIdleAvg, this, &RSIObject::updateIdleAvg, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::minimize, this, &RSIObject::minimize,  Qt::QueuedConnection );
     connect(m_timer, &RSITimer::relax, m_relaxpopup, &RSIRelaxPopup::relax, Qt::QueuedConnection );
+    connect(m_timer, &RSITimer::relax, this, &RSIObject::breakSuggested, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::tinyBreakSkipped, this, &RSIObject::tinyBreakSkipped, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::bigBreakSkipped, this, &RSIObject::bigBreakSkipped, Qt::QueuedConnection );
 
@@ -195,6 +284,7 @@ void RSIObject::configureTimer()
     connect(m_tray, &RSIDock::dialogEntered, m_timer, &RSITimer::slotStop);
     connect(m_tray, &RSIDock::dialogLeft, m_timer, &RSITimer::slotStart);
     connect(m_tray, &RSIDock::suspend, m_timer, &RSITimer::slotSuspended);
+    connect(m_tray, &RSIDock::resetStats, m_timer, &RSITimer::slotResetStats);
 
     connect(m_relaxpopup, &RSIRelaxPopup::skip, m_timer, &RSITimer::skipBreak);
     connect(m_relaxpopup, &RSIRelaxPopup::postpone, m_timer, &RSITimer::postponeBreak);
@@ -221,51 +311,99 @@ void RSIObject::readConfig()
     bool recursive =  config.readEntry( "SearchRecursiveCheck", false );
     bool showSmallImages = config.readEntry( "ShowSmallImagesCheck", true );
     const bool expandImageToFullScreen = config.readEntry( "ExpandImageToFullScreen", true );
+    const bool slideShowOnAllScreens = config.readEntry( "SlideShowOnAllScreens", false );
     QString path = config.readEntry( "ImageFolder" );
 
     configureTimer();
 
+    // Status bars can follow the status on a local socket instead of polling.
+    if ( !config.readEntry( "StatusSocket", false ) ) {
+        m_statusServer->close();
+    } else if ( !m_statusServer->isListening() && m_statusServer->listen() ) {
+        m_statusServer->publish( status() );
+    }
+
     int effect =  config.readEntry( "Effect", 0 );
+    m_preparation.setPrepareSeconds( config.readEntry( "PrepareSeconds", 30 ) );
+    m_preparation.reset();
+
+    // A slideshow without a folder falls back to gray.
+    if ( effect == SlideShow && ( path.isEmpty() || !QDir( path ).exists() ) )
+        effect = SimpleGray;
+
+    // The effects are kept for when the settings change again, only the
+    // one in use keeps its windows between breaks.
+    BreakBase *current = cachedEffect( effect );
+    if ( m_effect && m_effect != current ) {
+        m_effect->retire();
+        m_effect->setMemoryBudget( 0 );
+        m_effect->trimMemory();
+    }
+    m_effect = current;
 
-    delete m_effect;
     switch ( effect ) {
     case Plasma: {
-        m_effect = new PlasmaEffect( 0 );
         m_effect->setReadOnly( m_usePlasmaRO );
         break;
     }
     case SlideShow: {
-        SlideEffect* slide = new SlideEffect( 0 );
-        slide->reset( path, recursive, showSmallImages, expandImageToFullScreen, slideInterval );
-        if ( slide->hasImages() )
-            m_effect = slide;
-        else {
-            delete slide;
-            m_effect = new GrayEffect( 0 );
-        }
+        // The images are searched in the background, only when the
+        // folder changed.
+        SlideEffect* slide = static_cast<SlideEffect*>( m_effect );
+        slide->reset( path, recursive, showSmallImages, expandImageToFullScreen, slideInterval,
+                      slideShowOnAllScreens );
         break;
     }
-    case Popup: {
-        PopupEffect* effect = new PopupEffect( 0 );
-        m_effect = effect;
+    case Popup:
         break;
-    }
     case SimpleGray:
     default: {
-        GrayEffect* effect = new GrayEffect( 0 );
-        effect->setLevel( config.readEntry( "Graylevel", 80 ) );
-        m_effect = effect;
+        GrayEffect* gray = static_cast<GrayEffect*>( m_effect );
+        gray->setLevel( config.readEntry( "Graylevel", 80 ) );
         break;
     }
     }
-    connect(m_effect, &BreakBase::skip, m_timer, &RSITimer::skipBreak);
-    connect(m_effect, &BreakBase::lock, this, &RSIObject::slotLock);
-    connect(m_effect, &BreakBase::postpone, m_timer, &RSITimer::postponeBreak);
 
     m_effect->showMinimize( !config.readEntry( "HideMinimizeButton", false ) );
     m_effect->showLock( !config.readEntry( "HideLockButton", false ) );
     m_effect->showPostpone( !config.readEntry( "HidePostponeButton", false ) );
     m_effect->disableShortcut( config.readEntry( "DisableAccel", false ) );
+
+    // In MiB, a negative budget keeps everything between breaks.
+    const int budget = config.readEntry( "EffectMemoryBudget", 32 );
+    m_effect->setMemoryBudget( budget < 0 ? -1 : qint64( budget ) * 1024 * 1024 );
+}
+
+BreakBase* RSIObject::cachedEffect( int effect )
+{
+    if ( effect < SimpleGray || effect > Popup )
+        effect = SimpleGray;
+
+    BreakBase *cached = m_effects.value( effect );
+    if ( cached )
+        return cached;
+
+    switch ( effect ) {
+    case Plasma:
+        cached = new PlasmaEffect( 0 );
+        break;
+    case SlideShow:
+        cached = new SlideEffect( 0 );
+        break;
+    case Popup:
+        cached = new PopupEffect( 0 );
+        break;
+    case SimpleGray:
+    default:
+        cached = new GrayEffect( 0 );
+        break;
+    }
+    connect(cached, &BreakBase::skip, m_timer, &RSITimer::skipBreak);
+    connect(cached, &BreakBase::lock, this, &RSIObject::slotLock);
+    connect(cached, &BreakBase::postpone, m_timer, &RSITimer::postponeBreak);
+
+    m_effects.insert( effect, cached );
+    return cached;
 }
 
 void RSIObject::resume() {
@@ -275,3 +413,76 @@ void RSIObject::resume() {
 void RSIObject::suspend() {
     m_tray->doSuspend();
 }
+
+int RSIObject::idlePeriodPercentile( int percent )
+{
+    return RSIGlobals::instance()->stats()->snapshot()->idlePeriods().percentile( percent );
+}
+
+int RSIObject::workStreakPercentile( int percent )
+{
+    return RSIGlobals::instance()->stats()->snapshot()->workStreaks().percentile( percent );
+}
+
+QList<uint> RSIObject::idlePeriodHistogram()
+{
+    return RSIGlobals::instance()->stats()->snapshot()->idlePeriods().counts();
+}
+
+QList<uint> RSIObject::workStreakHistogram()
+{
+    return RSIGlobals::instance()->stats()->snapshot()->workStreaks().counts();
+}
+
+QVariantMap RSIObject::memoryReport()
+{
+    QMap<QString, qint64> parts;
+    m_effect->reportMemory( parts );
+
+    QVariantMap report;
+    qint64 total = 0;
+    for ( QMap<QString, qint64>::const_iterator it = parts.constBegin(); it != parts.constEnd(); ++it ) {
+        report.insert( it.key(), it.value() );
+        total += it.value();
+    }
+    report.insert( "total", total );
+    report.insert( "budget", m_effect->memoryBudget() );
+    report.insert( "effect", QString::fromLatin1( m_effect->metaObject()->className() ) );
+    return report;
+}
+
+QVariantMap RSIObject::activationReport()
+{
+    return RSIGlobals::instance()->activationTrace()->report();
+}
+
+QList<uint> RSIObject::activationLatencyHistogram()
+{
+    return RSIGlobals::instance()->activationTrace()->latencies().counts();
+}
+
+QVariantMap RSIObject::frameReport()
+{
+    return RSIGlobals::instance()->frameStats()->report();
+}
+
+QList<uint> RSIObject::frameTimeHistogram()
+{
+    return RSIGlobals::instance()->frameStats()->frameTimes().counts();
+}
+
+QVariantMap RSIObject::dbusReport()
+{
+    QVariantMap report;
+    report.insert( "lock", m_lockCall->report() );
+
+    const PlasmaEffect *plasma = qobject_cast<PlasmaEffect*>( m_effects.value( Plasma ) );
+    if ( plasma )
+        report.insert( "dashboard", plasma->dashboardCall()->report() );
+    return report;
+}
+
+QVariantMap RSIObject::hookReport()
+{
+    return RSIGlobals::instance()->notifier()->report();
+}
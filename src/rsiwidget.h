@@ -22,10 +22,17 @@
 #define RSIWIDGET_H
 
 #include "rsitimer.h"
+#include "rsistatus.h"
+#include "rsibreakpreparation.h"
+
+#include <QHash>
+#include <QVariantMap>
 
 class RSIDock;
 class RSIRelaxPopup;
 class BreakBase;
+class RSIDBusCall;
+class RSIStatusServer;
 
 class QLabel;
 
@@ -68,6 +75,9 @@ private slots:
     void minimize();
     void maximize();
     void setCounters( int );
+    void prepareBreak( int tinyLeft, int bigLeft );
+    void breakSuggested( int breakLeft );
+    void updateCounters( int tinyLeft, int bigLeft );
     void updateIdleAvg( double );
     void readConfig();
     void tinyBreakSkipped();
@@ -82,27 +92,55 @@ private:
     void loadImage();
     void configureTimer();
 
+    // Fills in the rest of m_status and sends StatusChanged when a client
+    // would show something else.
+    void updateStatus();
+
+    // @returns the effect of type @p effect, created the first time.
+    BreakBase* cachedEffect( int effect );
+
     RSIDock*        m_tray;
     RSITimer*       m_timer;
     BreakBase*      m_effect;
+    QHash<int, BreakBase*> m_effects;
 
     bool            m_useImages;
 
     bool            m_usePlasma;
     bool            m_usePlasmaRO;
 
+    RSIBreakPreparation m_preparation;
+
     RSIRelaxPopup*  m_relaxpopup;
 
     QString         m_currentIcon;
 
+    RSIDBusCall*    m_lockCall;
+
+    // The current status and the one last sent with StatusChanged.
+    RSIStatus       m_status;
+    RSIStatus       m_sentStatus;
+
+    RSIStatusServer* m_statusServer;
+
+
+Q_SIGNALS:
+    /**
+     * Sent when something a status applet shows has changed, so it does
+     * not need to poll. The counters only change it once a minute, and
+     * every second in the last minute.
+     */
+    void StatusChanged( const RSIStatus &status );
 
     /* Available through D-Bus */
 public Q_SLOTS:
     void resume();
     void suspend();
-    int idleTime() {
-        return timer()->idleTime();
-    }
+    /**
+     * The seconds the user was idle at the last tick of the timer, from
+     * the published statistics.
+     */
+    int idleTime();
     int tinyLeft() {
         return timer()->tinyLeft();
     }
@@ -112,6 +150,94 @@ public Q_SLOTS:
     QString currentIcon() {
         return m_currentIcon;
     }
+
+    /**
+     * Everything tinyLeft(), bigLeft(), idleTime() and currentIcon() return
+     * and more, in a single call.
+     */
+    RSIStatus status();
+
+    /**
+     * The length in seconds below which @p percent percent of the idle
+     * periods fall, for example 50, 90 or 99.
+     */
+    int idlePeriodPercentile( int percent );
+
+    /**
+     * The length in seconds below which @p percent percent of the work
+     * streaks fall, for example 50, 90 or 99.
+     */
+    int workStreakPercentile( int percent );
+
+    /**
+     * The bucket counts of the idle period histogram. Histograms of
+     * several users can be merged by adding up the buckets.
+     * @see RSIHistogram
+     */
+    QList<uint> idlePeriodHistogram();
+
+    /**
+     * The bucket counts of the work streak histogram.
+     * @see RSIHistogram
+     */
+    QList<uint> workStreakHistogram();
+
+    /**
+     * The memory held by the break effect, in bytes for each of its parts,
+     * with the "total", the "budget" it may keep between breaks and the
+     * class name of the "effect".
+     */
+    QVariantMap memoryReport();
+
+    /**
+     * How long it took to show the last break, in microseconds since the
+     * timer asked for it: until it was "delivered" to the GUI, until the
+     * effect was "activated" and until all screens were "painted". The
+     * first paint of every screen is in "screens". "p50", "p90" and "p99"
+     * are the latency percentiles in milliseconds over "count" breaks.
+     * @see RSIActivationTrace
+     */
+    QVariantMap activationReport();
+
+    /**
+     * The bucket counts of the break latency histogram, in milliseconds.
+     * @see RSIHistogram
+     */
+    QList<uint> activationLatencyHistogram();
+
+    /**
+     * The frame times of the fades and cross-fades: the "transitions", the
+     * "frames" drawn and the "dropped" ones, "p50", "p90" and "p99" of the
+     * frame times in microseconds, the "renderTime" and "blendTime" in
+     * microseconds and the "cpuShare" of the transitions in percent.
+     * @see RSIFrameStats
+     */
+    QVariantMap frameReport();
+
+    /**
+     * The bucket counts of the frame time histogram, in microseconds.
+     * @see RSIHistogram
+     */
+    QList<uint> frameTimeHistogram();
+
+    /**
+     * The calls made to other programs over D-Bus, without waiting for
+     * them: "lock" for the screen saver and "dashboard" for Plasma. Each
+     * has the "calls", the ones still "pending", the "errors", the
+     * "timeouts", the "lastError" and "p50", "p90" and "p99" of the round
+     * trips in milliseconds.
+     * @see RSIDBusCall
+     */
+    QVariantMap dbusReport();
+
+    /**
+     * The hook commands run at the start and the end of the breaks: how
+     * many were "started", "failed", ran into a timeout ("timeouts") or
+     * were "dropped" because too many were waiting, and how many are
+     * "running" and "queued" now.
+     * @see RSINotifier
+     */
+    QVariantMap hookReport();
 };
 
 #   endif
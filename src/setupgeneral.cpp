@@ -36,6 +36,7 @@ class SetupGeneralPriv
 {
 public:
     QCheckBox*        autoStart;
+    QCheckBox*        statusSocket;
     QGroupBox*        breakTimerSettings;
     QRadioButton*     useNoIdleTimer;
     QRadioButton*     useIdleTimer;
@@ -53,6 +54,12 @@ SetupGeneral::SetupGeneral( QWidget* parent )
     d->autoStart->setWhatsThis( i18n( "With this option you can indicate that "
                                       "you want RSIBreak to start on Desktop Environment start." ) );
 
+    d->statusSocket = new QCheckBox(
+        i18n( "Share the status with &status bars" ), this );
+    d->statusSocket->setWhatsThis( i18n( "With this option RSIBreak writes its status "
+                                         "to the socket rsibreak-status in the runtime directory, "
+                                         "one JSON object per line, for status bars like "
+                                         "Waybar or polybar." ) );
 
     d->breakTimerSettings = new QGroupBox( i18n( "Timer Settings" ), this );
     d->useNoIdleTimer = new QRadioButton( i18n( "Break at &fixed times" ), this );
@@ -71,6 +78,7 @@ SetupGeneral::SetupGeneral( QWidget* parent )
     connect(d->useIdleTimer, &QRadioButton::toggled, this, &SetupGeneral::useIdleTimerChanged);
 
     l->addWidget( d->autoStart );
+    l->addWidget( d->statusSocket );
     l->addWidget( d->breakTimerSettings );
 
     setLayout( l );
@@ -89,6 +97,7 @@ void SetupGeneral::applySettings()
 
     config = KSharedConfig::openConfig()->group( "General Settings" );
     config.writeEntry( "UseNoIdleTimer", d->useNoIdleTimer->isChecked() );
+    config.writeEntry( "StatusSocket", d->statusSocket->isChecked() );
     config.sync();
 }
 
@@ -105,4 +114,5 @@ void SetupGeneral::readSettings()
     config = KSharedConfig::openConfig()->group( "General Settings" );
     d->useNoIdleTimer->setChecked( config.readEntry( "UseNoIdleTimer", false ) );
     d->useIdleTimer->setChecked( !d->useNoIdleTimer->isChecked() );
+    d->statusSocket->setChecked( config.readEntry( "StatusSocket", false ) );
 }
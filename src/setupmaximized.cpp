@@ -31,6 +31,7 @@
 #include <QLabel>
 #include <QLineEdit>
 #include <QSlider>
+#include <QSpinBox>
 #include <QVBoxLayout>
 #include <QGroupBox>
 
@@ -62,6 +63,8 @@ public:
     QPushButton*      changePathButton;
     KPluralHandlingSpinBox*     slideInterval;
     KPluralHandlingSpinBox*     popupDuration;
+    QSpinBox*         memoryBudget;
+    KPluralHandlingSpinBox*     prepareSeconds;
     QLabel*                     popupDurationLabel;
     QGroupBox*        popupBox;
     QCheckBox*        usePopup;
@@ -73,6 +76,7 @@ public:
     QSlider*          graySlider;
     QCheckBox* showSmallImagesCheck;
     QCheckBox*        expandImageToFullScreen;
+    QCheckBox*        slideShowOnAllScreens;
 };
 
 SetupMaximized::SetupMaximized( QWidget* parent )
@@ -97,6 +101,37 @@ SetupMaximized::SetupMaximized( QWidget* parent )
 
     connect(d->effectBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &SetupMaximized::slotEffectChanged);
 
+    QWidget *m7 = new QWidget( this );
+    QHBoxLayout *m7HBoxLayout = new QHBoxLayout(m7);
+    m7HBoxLayout->setMargin(0);
+    QLabel *l7 = new QLabel( i18n( "Memory kept between breaks:" ) + ' ', m7 );
+    m7HBoxLayout->addWidget(l7);
+    l7->setAlignment( Qt::AlignRight | Qt::AlignVCenter );
+    l7->setWhatsThis( i18n( "The windows and images of the effect take memory, "
+                            "which is released after a break when it is more than this. "
+                            "They are built again for the next break." ) );
+    d->memoryBudget = new QSpinBox( m7 );
+    m7HBoxLayout->addWidget(d->memoryBudget);
+    d->memoryBudget->setRange( 0, 1024 );
+    d->memoryBudget->setSuffix( i18n( " MiB" ) );
+    d->memoryBudget->setSpecialValueText( i18n( "None" ) );
+    l7->setBuddy( d->memoryBudget );
+
+    QWidget *m8 = new QWidget( this );
+    QHBoxLayout *m8HBoxLayout = new QHBoxLayout(m8);
+    m8HBoxLayout->setMargin(0);
+    QLabel *l8 = new QLabel( i18n( "Prepare the effect before a break:" ) + ' ', m8 );
+    m8HBoxLayout->addWidget(l8);
+    l8->setAlignment( Qt::AlignRight | Qt::AlignVCenter );
+    l8->setWhatsThis( i18n( "The windows and the first image of the effect are prepared "
+                            "this long before a break, so the break starts without delay." ) );
+    d->prepareSeconds = new KPluralHandlingSpinBox( m8 );
+    m8HBoxLayout->addWidget(d->prepareSeconds);
+    d->prepareSeconds->setRange( 0, 300 );
+    d->prepareSeconds->setSuffix( ki18np( " second", " seconds" ) );
+    d->prepareSeconds->setSpecialValueText( i18n( "Never" ) );
+    l8->setBuddy( d->prepareSeconds );
+
     //---------------- SKIP BOX
     QGroupBox *skipBox = new QGroupBox( this );
     skipBox->setTitle( i18n( "Skipping Breaks" ) );
@@ -183,6 +218,11 @@ SetupMaximized::SetupMaximized( QWidget* parent )
     d->expandImageToFullScreen->setWhatsThis( i18n( "If checked then image will be expanded to full screen. "
                                                     "Part of the image outside the screen area will be cropped. "
                                                     "Otherwise the image will be displayed completely but there may grey areas around it. " ) );
+    d->slideShowOnAllScreens = new QCheckBox ( i18n( "Show images on all screens" ),
+            this );
+    d->slideShowOnAllScreens->setWhatsThis( i18n( "If checked then every screen shows its own images. "
+                                                  "Otherwise the images are shown on the primary screen only "
+                                                  "and the other screens are grayed out." ) );
 
     QWidget *m5 = new QWidget( this );
     QHBoxLayout *m5HBoxLayout = new QHBoxLayout(m5);
@@ -205,6 +245,7 @@ SetupMaximized::SetupMaximized( QWidget* parent )
     vboxg->addWidget( d->searchRecursiveCheck );
     vboxg->addWidget( d->showSmallImagesCheck );
     vboxg->addWidget( d->expandImageToFullScreen );
+    vboxg->addWidget( d->slideShowOnAllScreens );
     vboxg->addWidget( m5 );
     d->slideshowBox->setLayout( vboxg );
 
@@ -254,6 +295,8 @@ SetupMaximized::SetupMaximized( QWidget* parent )
 
     l->addWidget( d->effectLabel );
     l->addWidget( d->effectBox );
+    l->addWidget( m7 );
+    l->addWidget( m8 );
     l->addWidget( d->grayBox );
     l->addWidget( d->plasmaBox );
     l->addWidget( d->slideshowBox );
@@ -352,6 +395,8 @@ void SetupMaximized::applySettings()
                        d->showSmallImagesCheck->isChecked() );
     config.writeEntry( "ExpandImageToFullScreen",
                        d->expandImageToFullScreen->isChecked() );
+    config.writeEntry( "SlideShowOnAllScreens",
+                       d->slideShowOnAllScreens->isChecked() );
     config.writeEntry( "Effect",
                        d->effectBox->itemData( d->effectBox->currentIndex() ) );
 
@@ -359,6 +404,8 @@ void SetupMaximized::applySettings()
     config.writeEntry( "UsePlasmaReadOnly",
                        d->readOnlyPlasma->isChecked() );
     config.writeEntry( "Graylevel", d->graySlider->value() );
+    config.writeEntry( "EffectMemoryBudget", d->memoryBudget->value() );
+    config.writeEntry( "PrepareSeconds", d->prepareSeconds->value() );
     config = KSharedConfig::openConfig()->group( "Popup Settings" );
     config.writeEntry( "UsePopup",
                        d->usePopup->isChecked() );
@@ -397,10 +444,14 @@ void SetupMaximized::readSettings()
         config.readEntry( "ShowSmallImagesCheck", true ) );
     d->expandImageToFullScreen->setChecked(
         config.readEntry( "ExpandImageToFullScreen", true ) );
+    d->slideShowOnAllScreens->setChecked(
+        config.readEntry( "SlideShowOnAllScreens", false ) );
     d->disableAccel->setChecked( config.readEntry( "DisableAccel", false ) );
     d->readOnlyPlasma->setChecked(
         config.readEntry( "UsePlasmaReadOnly", true ) );
     d->graySlider->setValue( config.readEntry( "Graylevel", 80 ) );
+    d->memoryBudget->setValue( config.readEntry( "EffectMemoryBudget", 32 ) );
+    d->prepareSeconds->setValue( config.readEntry( "PrepareSeconds", 30 ) );
     config = KSharedConfig::openConfig()->group( "Popup Settings" );
     d->usePopup->setChecked(
         config.readEntry( "UsePopup", true ) );
@@ -21,10 +21,17 @@
 #include "setupnotifications.h"
 
 // QT includes.
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
 #include <QVBoxLayout>
 
 // KDE includes.
+#include <KConfigGroup>
+#include <KLocalizedString>
 #include <KNotifyConfigWidget>
+#include <KSharedConfig>
 
 SetupNotifications::SetupNotifications( QWidget* parent )
         : QWidget( parent )
@@ -33,6 +40,35 @@ SetupNotifications::SetupNotifications( QWidget* parent )
     m_notify = new KNotifyConfigWidget( this );
     m_notify->setApplication( "rsibreak" );
     l->addWidget( m_notify );
+
+    QGroupBox *commandBox = new QGroupBox( i18n( "Commands" ), this );
+    commandBox->setWhatsThis( i18n( "Shell commands which are run at the start and at the "
+                                    "end of every break, for example to pause the music. "
+                                    "RSIBREAK_EVENT is set to start or end and RSIBREAK_BREAK "
+                                    "to short or long." ) );
+    QVBoxLayout *commandLayout = new QVBoxLayout( commandBox );
+
+    QHBoxLayout *startRow = new QHBoxLayout();
+    QLabel *startLabel = new QLabel( i18n( "Run at the start of a break:" ), commandBox );
+    m_startCommand = new QLineEdit( commandBox );
+    startLabel->setBuddy( m_startCommand );
+    startRow->addWidget( startLabel );
+    startRow->addWidget( m_startCommand );
+    commandLayout->addLayout( startRow );
+
+    QHBoxLayout *endRow = new QHBoxLayout();
+    QLabel *endLabel = new QLabel( i18n( "Run at the end of a break:" ), commandBox );
+    m_endCommand = new QLineEdit( commandBox );
+    endLabel->setBuddy( m_endCommand );
+    endRow->addWidget( endLabel );
+    endRow->addWidget( m_endCommand );
+    commandLayout->addLayout( endRow );
+
+    l->addWidget( commandBox );
+
+    KConfigGroup config = KSharedConfig::openConfig()->group( "General Settings" );
+    m_startCommand->setText( config.readEntry( "BreakStartCommand", QString() ) );
+    m_endCommand->setText( config.readEntry( "BreakEndCommand", QString() ) );
 }
 
 SetupNotifications::~SetupNotifications()
@@ -42,4 +78,9 @@ SetupNotifications::~SetupNotifications()
 void SetupNotifications::save()
 {
     m_notify->save();
+
+    KConfigGroup config = KSharedConfig::openConfig()->group( "General Settings" );
+    config.writeEntry( "BreakStartCommand", m_startCommand->text() );
+    config.writeEntry( "BreakEndCommand", m_endCommand->text() );
+    config.sync();
 }
@@ -23,6 +23,7 @@
 #include <qwidget.h>
 
 class KNotifyConfigWidget;
+class QLineEdit;
 
 /**
  * @class SetupTiming
@@ -52,6 +53,8 @@ public:
 
 private:
     KNotifyConfigWidget *m_notify;
+    QLineEdit *m_startCommand;
+    QLineEdit *m_endCommand;
 };
 
 #endif /* SETUPNOTIFICATIONS_H */
@@ -0,0 +1,253 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slideanimation.h"
+
+#include <QImageReader>
+#include <QMutex>
+#include <QQueue>
+#include <QRunnable>
+#include <QTimer>
+#include <QWaitCondition>
+
+// Frames may be decoded ahead in this much memory, in bytes, but always
+// at least two and at most eight of them.
+static const qint64 ringMemory = 16 * 1024 * 1024;
+static const int minimumRingFrames = 2;
+static const int maximumRingFrames = 8;
+
+// Browsers show frames without a delay for 100 ms, do not go below 20 ms.
+static const int minimumDelay = 20;
+
+class SlideFrameRing
+{
+public:
+    struct Frame {
+        QImage image;
+        int delay;
+    };
+
+    explicit SlideFrameRing( int capacity )
+            : m_capacity( capacity ), m_cancelled( false ), m_finished( false ) {}
+
+    // Waits for room in the ring. @returns false when cancelled.
+    bool push( const Frame &frame ) {
+        QMutexLocker locker( &m_mutex );
+        while ( m_frames.count() >= m_capacity && !m_cancelled )
+            m_notFull.wait( &m_mutex );
+        if ( m_cancelled )
+            return false;
+        m_frames.enqueue( frame );
+        return true;
+    }
+
+    bool pop( Frame *frame ) {
+        QMutexLocker locker( &m_mutex );
+        if ( m_frames.isEmpty() )
+            return false;
+        *frame = m_frames.dequeue();
+        m_notFull.wakeAll();
+        return true;
+    }
+
+    void cancel() {
+        QMutexLocker locker( &m_mutex );
+        m_cancelled = true;
+        m_frames.clear();
+        m_notFull.wakeAll();
+    }
+
+    bool isCancelled() const {
+        QMutexLocker locker( &m_mutex );
+        return m_cancelled;
+    }
+
+    void finish() {
+        QMutexLocker locker( &m_mutex );
+        m_finished = true;
+    }
+
+    // @returns true when all frames were decoded and taken.
+    bool isDone() const {
+        QMutexLocker locker( &m_mutex );
+        return m_finished && m_frames.isEmpty();
+    }
+
+    qint64 memoryUsage() const {
+        QMutexLocker locker( &m_mutex );
+        qint64 bytes = 0;
+        foreach( const Frame &frame, m_frames )
+            bytes += frame.image.byteCount();
+        return bytes;
+    }
+
+private:
+    mutable QMutex  m_mutex;
+    QWaitCondition  m_notFull;
+    QQueue<Frame>   m_frames;
+    int             m_capacity;
+    bool            m_cancelled;
+    bool            m_finished;
+};
+
+namespace
+{
+
+class AnimationJob : public QRunnable
+{
+public:
+    AnimationJob( QObject *animation, const QSharedPointer<SlideFrameRing> &ring, int generation,
+                  const QString &path, const QSize &size )
+            : m_animation( animation ), m_ring( ring ), m_generation( generation ),
+              m_path( path ), m_size( size ) {}
+
+    void run() override {
+        // Most formats can not rewind, a loop reads the image again.
+        for ( int loop = 0; !m_ring->isCancelled(); ++loop ) {
+            QImageReader reader( m_path );
+            reader.setScaledSize( m_size );
+            const int loopCount = reader.loopCount();
+
+            int frames = 0;
+            while ( reader.canRead() ) {
+                QImage image = reader.read();
+                if ( image.isNull() )
+                    break;
+                if ( image.size() != m_size )
+                    image = image.scaled( m_size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+
+                SlideFrameRing::Frame frame;
+                frame.image = image;
+                frame.delay = qMax( reader.nextImageDelay(), minimumDelay );
+                if ( !m_ring->push( frame ) )
+                    return;
+
+                // The animation waits for all jobs before it is destroyed.
+                QMetaObject::invokeMethod( m_animation, "slotDecoded", Qt::QueuedConnection,
+                                           Q_ARG( int, m_generation ) );
+                ++frames;
+            }
+
+            // A loop count of -1 repeats forever.
+            if ( frames < 2 || ( loopCount >= 0 && loop >= loopCount ) )
+                break;
+        }
+
+        m_ring->finish();
+        QMetaObject::invokeMethod( m_animation, "slotDecoded", Qt::QueuedConnection,
+                                   Q_ARG( int, m_generation ) );
+    }
+
+private:
+    QObject                         *m_animation;
+    QSharedPointer<SlideFrameRing>   m_ring;
+    int                              m_generation;
+    QString                          m_path;
+    QSize                            m_size;
+};
+
+}
+
+SlideAnimation::SlideAnimation( QObject *parent )
+        : QObject( parent ), m_generation( 0 ), m_waiting( false )
+{
+    m_timer = new QTimer( this );
+    m_timer->setSingleShot( true );
+    m_timer->setTimerType( Qt::PreciseTimer );
+    connect( m_timer, &QTimer::timeout, this, &SlideAnimation::slotFrameDue );
+
+    // A stopped animation finishes its frame in the background while the
+    // next one starts.
+    m_pool.setMaxThreadCount( 2 );
+}
+
+SlideAnimation::~SlideAnimation()
+{
+    stop();
+    m_pool.waitForDone();
+}
+
+bool SlideAnimation::isAnimated( const QString &path )
+{
+    QImageReader reader( path );
+    // The count is 0 when the format does not know it up front.
+    return reader.supportsAnimation() && reader.imageCount() != 1;
+}
+
+void SlideAnimation::start( const QString &path, const QSize &size )
+{
+    stop();
+    if ( size.isEmpty() )
+        return;
+
+    const qint64 frameBytes = qint64( size.width() ) * size.height() * 4;
+    const int capacity = int( qBound( qint64( minimumRingFrames ), ringMemory / frameBytes,
+                                      qint64( maximumRingFrames ) ) );
+
+    ++m_generation;
+    m_ring = QSharedPointer<SlideFrameRing>( new SlideFrameRing( capacity ) );
+    m_waiting = true;
+    m_pool.start( new AnimationJob( this, m_ring, m_generation, path, size ) );
+}
+
+void SlideAnimation::stop()
+{
+    m_timer->stop();
+    m_waiting = false;
+    if ( m_ring ) {
+        m_ring->cancel();
+        m_ring.clear();
+    }
+}
+
+bool SlideAnimation::isRunning() const
+{
+    return !m_ring.isNull();
+}
+
+qint64 SlideAnimation::memoryUsage() const
+{
+    return m_ring ? m_ring->memoryUsage() : 0;
+}
+
+void SlideAnimation::slotDecoded( int generation )
+{
+    if ( generation != m_generation || !m_waiting )
+        return;
+
+    slotFrameDue();
+}
+
+void SlideAnimation::slotFrameDue()
+{
+    if ( !m_ring )
+        return;
+
+    SlideFrameRing::Frame next;
+    if ( !m_ring->pop( &next ) ) {
+        // The last frame stays once the animation is done, otherwise the
+        // next one is shown as soon as it is decoded.
+        if ( m_ring->isDone() )
+            stop();
+        else
+            m_waiting = true;
+        return;
+    }
+
+    m_waiting = false;
+    emit frame( next.image );
+    m_timer->start( next.delay );
+}
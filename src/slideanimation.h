@@ -0,0 +1,83 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_SLIDEANIMATION_H
+#define RSIBREAK_SLIDEANIMATION_H
+
+#include <QImage>
+#include <QObject>
+#include <QSharedPointer>
+#include <QThreadPool>
+
+class QTimer;
+class SlideFrameRing;
+
+/**
+ * Plays an animated slide, like an animated GIF, MNG or WebP, or an APNG
+ * when there is a plugin for it. A worker decodes the frames as a stream
+ * and scales them to the slide size into a ring of a few frames. A long
+ * animation is never in memory as a whole, the worker waits while the
+ * ring is full.
+ *
+ * The worker reads when each frame is due together with the frame, the
+ * GUI thread only takes it from the ring when its time has come. A frame
+ * which is not decoded in time is shown as soon as it is there.
+ */
+class SlideAnimation : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SlideAnimation( QObject *parent = 0 );
+    ~SlideAnimation();
+
+    /**
+     * @returns true when the image at @p path might have more than one
+     * frame. Reads the header of the image, call it on a worker.
+     */
+    static bool isAnimated( const QString &path );
+
+    /**
+     * Starts playing the image at @p path, every frame scaled to @p size.
+     * A running animation is stopped.
+     */
+    void start( const QString &path, const QSize &size );
+
+    /** Stops playing, the last frame shown stays. */
+    void stop();
+
+    bool isRunning() const;
+
+    /** @returns the memory taken by the frames in the ring, in bytes. */
+    qint64 memoryUsage() const;
+
+signals:
+    /** Show @p frame now. */
+    void frame( const QImage &frame );
+
+private slots:
+    void slotFrameDue();
+    void slotDecoded( int generation );
+
+private:
+    QThreadPool                     m_pool;
+    QSharedPointer<SlideFrameRing>  m_ring;
+    QTimer*                         m_timer;
+    int                             m_generation;
+    bool                            m_waiting;
+};
+
+#endif //RSIBREAK_SLIDEANIMATION_H
@@ -0,0 +1,166 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slidecache.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <utime.h>
+
+SlideCache::SlideCache( const QString &directory, qint64 maximumSize )
+        : m_directory( directory ), m_maximumSize( maximumSize ), m_indexed( false ),
+          m_size( 0 ), m_lastUse( 0 )
+{
+    if ( m_directory.isEmpty() )
+        m_directory = QStandardPaths::writableLocation( QStandardPaths::CacheLocation ) + "/slides";
+}
+
+QString SlideCache::key( const QString &path, const QDateTime &modified, const Target &target )
+{
+    QCryptographicHash hash( QCryptographicHash::Sha1 );
+    hash.addData( path.toUtf8() );
+    hash.addData( '@' + QByteArray::number( modified.toMSecsSinceEpoch() ) );
+    hash.addData( '@' + QByteArray::number( target.size.width() ) +
+                  'x' + QByteArray::number( target.size.height() ) );
+    hash.addData( '@' + QByteArray::number( int( target.mode ) ) +
+                  '@' + QByteArray::number( target.minimumSurface ) );
+    return QString::fromLatin1( hash.result().toHex() );
+}
+
+QImage SlideCache::find( const QString &path, const QDateTime &modified, const Target &target )
+{
+    const QString file = key( path, modified, target );
+    {
+        QMutexLocker locker( &m_mutex );
+        index();
+        if ( !m_entries.contains( file ) )
+            return QImage();
+        touch( file );
+    }
+
+    QImage slide;
+    if ( !slide.load( m_directory + '/' + file ) ) {
+        // Removed or damaged behind our back, forget about it.
+        QMutexLocker locker( &m_mutex );
+        if ( m_entries.contains( file ) ) {
+            const Entry entry = m_entries.take( file );
+            m_lru.remove( entry.lastUse );
+            m_size -= entry.size;
+        }
+        QFile::remove( m_directory + '/' + file );
+    }
+
+    return slide;
+}
+
+void SlideCache::insert( const QString &path, const QDateTime &modified, const Target &target,
+                         const QImage &slide )
+{
+    if ( slide.isNull() || !QDir().mkpath( m_directory ) )
+        return;
+
+    const QString file = key( path, modified, target );
+
+    // Photos are much smaller as JPEG, only keep PNG for transparency.
+    QSaveFile out( m_directory + '/' + file );
+    if ( !out.open( QIODevice::WriteOnly ) ||
+            !slide.save( &out, slide.hasAlphaChannel() ? "PNG" : "JPG",
+                         slide.hasAlphaChannel() ? -1 : 90 ) ||
+            !out.commit() ) {
+        qWarning() << "Could not cache slide for" << path;
+        return;
+    }
+
+    const qint64 size = QFileInfo( m_directory + '/' + file ).size();
+
+    QMutexLocker locker( &m_mutex );
+    index();
+    if ( m_entries.contains( file ) ) {
+        const Entry entry = m_entries.take( file );
+        m_lru.remove( entry.lastUse );
+        m_size -= entry.size;
+    }
+
+    Entry entry;
+    entry.size = size;
+    entry.lastUse = 0;
+    m_entries.insert( file, entry );
+    m_size += size;
+    touch( file );
+    evict();
+}
+
+qint64 SlideCache::size()
+{
+    QMutexLocker locker( &m_mutex );
+    index();
+    return m_size;
+}
+
+void SlideCache::index()
+{
+    if ( m_indexed )
+        return;
+    m_indexed = true;
+
+    // The modification time of an entry is the last time it was used,
+    // oldest first.
+    QDir dir( m_directory );
+    const QFileInfoList list = dir.entryInfoList( QDir::Files, QDir::Time | QDir::Reversed );
+    for ( int i = 0; i < list.count(); ++i ) {
+        const QFileInfo &fi = list.at( i );
+
+        Entry entry;
+        entry.size = fi.size();
+        entry.lastUse = qMax( fi.lastModified().toMSecsSinceEpoch(), m_lastUse + 1 );
+        m_lastUse = entry.lastUse;
+
+        m_entries.insert( fi.fileName(), entry );
+        m_lru.insert( entry.lastUse, fi.fileName() );
+        m_size += entry.size;
+    }
+
+    evict();
+}
+
+void SlideCache::touch( const QString &file )
+{
+    Entry &entry = m_entries[ file ];
+    m_lru.remove( entry.lastUse );
+
+    entry.lastUse = qMax( QDateTime::currentMSecsSinceEpoch(), m_lastUse + 1 );
+    m_lastUse = entry.lastUse;
+    m_lru.insert( entry.lastUse, file );
+
+    // Remember the order for the next session.
+    utime( QFile::encodeName( m_directory + '/' + file ).constData(), 0 );
+}
+
+void SlideCache::evict()
+{
+    while ( m_size > m_maximumSize && !m_lru.isEmpty() ) {
+        const QString file = m_lru.take( m_lru.firstKey() );
+        m_size -= m_entries.take( file ).size;
+        QFile::remove( m_directory + '/' + file );
+    }
+}
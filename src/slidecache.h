@@ -0,0 +1,97 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_SLIDECACHE_H
+#define RSIBREAK_SLIDECACHE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QImage>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+/**
+ * Keeps slides which were already scaled for the screen on disk, so a
+ * slide which is shown again does not need to decode the original image.
+ * Entries are found by the path and modification time of the original,
+ * and the target they were scaled for. When the cache grows beyond its
+ * maximum size, the entries which were used longest ago are removed.
+ *
+ * All methods are safe to call from any thread.
+ */
+class SlideCache
+{
+public:
+    /**
+     * @param directory Where the slides are stored. Defaults to a folder in
+     * the cache location of the user.
+     * @param maximumSize The maximum amount of bytes used on disk.
+     */
+    explicit SlideCache( const QString &directory = QString(),
+                         qint64 maximumSize = 256 * 1024 * 1024 );
+
+    /**
+     * Describes how a slide was scaled, slides for another target are never
+     * found.
+     */
+    struct Target {
+        QSize size;
+        Qt::AspectRatioMode mode;
+        int minimumSurface;
+    };
+
+    /** @returns the scaled slide for @p path or a null image when it is not cached. */
+    QImage find( const QString &path, const QDateTime &modified, const Target &target );
+
+    /** Stores the scaled @p slide for @p path. */
+    void insert( const QString &path, const QDateTime &modified, const Target &target,
+                 const QImage &slide );
+
+    /** @returns the amount of bytes used on disk. */
+    qint64 size();
+
+    QString directory() const { return m_directory; }
+
+private:
+    struct Entry {
+        qint64 size;
+        qint64 lastUse;
+    };
+
+    static QString key( const QString &path, const QDateTime &modified, const Target &target );
+
+    // Reads the entries which are already on disk, on first use.
+    void index();
+
+    // Marks @p file as used just now.
+    void touch( const QString &file );
+
+    // Removes entries till the cache fits in its maximum size again.
+    void evict();
+
+    QString                 m_directory;
+    qint64                  m_maximumSize;
+
+    QMutex                  m_mutex;
+    bool                    m_indexed;
+    qint64                  m_size;
+    qint64                  m_lastUse;
+    QHash<QString, Entry>   m_entries;      // file name -> entry
+    QMap<qint64, QString>   m_lru;          // last use -> file name
+};
+
+#endif //RSIBREAK_SLIDECACHE_H
@@ -0,0 +1,424 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slidecatalog.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <cstring>
+
+const quint32 SlideCatalog::NoImage;
+const quint32 SlideCatalog::NoFolder;
+
+static QString fileNameOf( const QString &path )
+{
+    return path.mid( path.lastIndexOf( '/' ) + 1 );
+}
+
+static quint16 dimension( int value )
+{
+    return quint16( qBound( 0, value, 0xffff ) );
+}
+
+SlideCatalog::SlideCatalog()
+        : m_unusedNames( 0 )
+{
+}
+
+quint32 SlideCatalog::addFolder( const QString &folder )
+{
+    quint32 folderId = m_folderIds.value( folder, NoFolder );
+    if ( folderId == NoFolder ) {
+        folderId = m_folders.count();
+        Folder entry;
+        entry.path = folder;
+        entry.modified = 0;
+        m_folders.append( entry );
+        m_folderIds.insert( folder, folderId );
+    }
+    return folderId;
+}
+
+void SlideCatalog::setFolder( const QString &folder, qint64 modified, const QStringList &images,
+                              const QList<QSize> &sizes,
+                              QVector<quint32> *added, QVector<quint32> *removed )
+{
+    const quint32 folderId = addFolder( folder );
+    m_folders[ folderId ].modified = modified;
+
+    // Only index the names of this folder, and only while it is updated.
+    QHash<QString, quint32> old;
+    old.reserve( m_folders.at( folderId ).images.count() );
+    foreach( quint32 id, m_folders.at( folderId ).images )
+        old.insert( fileName( m_images.at( id ) ), id );
+
+    QVector<quint32> kept;
+    kept.reserve( images.count() );
+    QList<int> fresh;
+    for ( int i = 0; i < images.count(); ++i ) {
+        QHash<QString, quint32>::iterator it = old.find( fileNameOf( images.at( i ) ) );
+        if ( it == old.end() ) {
+            fresh.append( i );
+            continue;
+        }
+
+        Image &image = m_images[ it.value() ];
+        image.width = dimension( sizes.value( i ).width() );
+        image.height = dimension( sizes.value( i ).height() );
+        kept.append( it.value() );
+        old.erase( it );
+    }
+
+    // Release first, so the new images can reuse the IDs.
+    for ( QHash<QString, quint32>::const_iterator it = old.constBegin(); it != old.constEnd(); ++it ) {
+        release( it.value() );
+        removed->append( it.value() );
+    }
+
+    foreach( int i, fresh ) {
+        const QSize size = sizes.value( i );
+        const quint32 id = insert( folderId, fileNameOf( images.at( i ) ).toUtf8(),
+                                   dimension( size.width() ), dimension( size.height() ) );
+        kept.append( id );
+        added->append( id );
+    }
+
+    m_folders[ folderId ].images = kept;
+}
+
+void SlideCatalog::removeFolder( const QString &folder, QVector<quint32> *removed )
+{
+    const QString prefix = folder + '/';
+    QHash<QString, quint32>::iterator it = m_folderIds.begin();
+    while ( it != m_folderIds.end() ) {
+        if ( it.key() != folder && !it.key().startsWith( prefix ) ) {
+            ++it;
+            continue;
+        }
+
+        // The entry stays in the table, but is not used again.
+        Folder &entry = m_folders[ it.value() ];
+        foreach( quint32 id, entry.images ) {
+            release( id );
+            removed->append( id );
+        }
+        entry.images.clear();
+        entry.path.clear();
+        it = m_folderIds.erase( it );
+    }
+}
+
+void SlideCatalog::remove( quint32 id )
+{
+    if ( !contains( id ) )
+        return;
+
+    m_folders[ m_images.at( id ).folder ].images.removeOne( id );
+    release( id );
+}
+
+void SlideCatalog::clear()
+{
+    m_images.clear();
+    m_free.clear();
+    m_names.clear();
+    m_unusedNames = 0;
+    m_folders.clear();
+    m_folderIds.clear();
+    m_shown.clear();
+    m_remembered.clear();
+}
+
+quint32 SlideCatalog::insert( quint32 folder, const QByteArray &name, quint16 width, quint16 height )
+{
+    Image image;
+    image.folder = folder;
+    image.name = m_names.size();
+    image.nameLength = quint16( qMin( name.size(), 0xffff ) );
+    image.width = width;
+    image.height = height;
+    m_names.append( name.constData(), image.nameLength );
+
+    quint32 id;
+    if ( !m_free.isEmpty() ) {
+        id = m_free.takeLast();
+        m_images[ id ] = image;
+    } else {
+        id = m_images.count();
+        m_images.append( image );
+    }
+
+    if ( id >= uint( m_shown.size() ) )
+        m_shown.resize( qMax( int( id ) + 1, m_shown.size() * 2 ) );
+    if ( !m_remembered.isEmpty() && m_remembered.remove( path( id ) ) )
+        m_shown.setBit( id );
+
+    return id;
+}
+
+void SlideCatalog::release( quint32 id )
+{
+    Image &image = m_images[ id ];
+    image.folder = NoFolder;
+    m_unusedNames += image.nameLength;
+    m_shown.clearBit( id );
+    m_free.append( id );
+
+    // Removed names are left in the arena until they take half of it.
+    if ( m_unusedNames > 4096 && m_unusedNames > m_names.size() / 2 )
+        compactNames();
+}
+
+void SlideCatalog::compactNames()
+{
+    QByteArray names;
+    names.reserve( m_names.size() - m_unusedNames );
+    for ( int i = 0; i < m_images.count(); ++i ) {
+        Image &image = m_images[ i ];
+        if ( image.folder == NoFolder )
+            continue;
+
+        const int offset = names.size();
+        names.append( m_names.constData() + image.name, image.nameLength );
+        image.name = offset;
+    }
+
+    m_names = names;
+    m_unusedNames = 0;
+}
+
+QString SlideCatalog::fileName( const Image &image ) const
+{
+    return QString::fromUtf8( m_names.constData() + image.name, image.nameLength );
+}
+
+QVector<quint32> SlideCatalog::images() const
+{
+    QVector<quint32> result;
+    result.reserve( count() );
+    for ( int i = 0; i < m_images.count(); ++i ) {
+        if ( m_images.at( i ).folder != NoFolder )
+            result.append( i );
+    }
+    return result;
+}
+
+QHash<QString, qint64> SlideCatalog::folders() const
+{
+    QHash<QString, qint64> result;
+    result.reserve( m_folderIds.count() );
+    for ( QHash<QString, quint32>::const_iterator it = m_folderIds.constBegin();
+            it != m_folderIds.constEnd(); ++it )
+        result.insert( it.key(), m_folders.at( it.value() ).modified );
+    return result;
+}
+
+quint32 SlideCatalog::find( const QString &path ) const
+{
+    const int slash = path.lastIndexOf( '/' );
+    const QString folder = slash == 0 ? QString( '/' ) : path.left( slash );
+    const quint32 folderId = m_folderIds.value( folder, NoFolder );
+    if ( folderId == NoFolder )
+        return NoImage;
+
+    const QByteArray name = path.mid( slash + 1 ).toUtf8();
+    foreach( quint32 id, m_folders.at( folderId ).images ) {
+        const Image &image = m_images.at( id );
+        if ( image.nameLength == name.size() &&
+                std::memcmp( m_names.constData() + image.name, name.constData(), name.size() ) == 0 )
+            return id;
+    }
+    return NoImage;
+}
+
+QString SlideCatalog::path( quint32 id ) const
+{
+    if ( !contains( id ) )
+        return QString();
+
+    const Image &image = m_images.at( id );
+    const QString &folder = m_folders.at( image.folder ).path;
+    if ( folder.endsWith( '/' ) )
+        return folder + fileName( image );
+    return folder + '/' + fileName( image );
+}
+
+QSize SlideCatalog::size( quint32 id ) const
+{
+    if ( !contains( id ) )
+        return QSize();
+
+    const Image &image = m_images.at( id );
+    if ( image.width == 0 || image.height == 0 )
+        return QSize();
+    return QSize( image.width, image.height );
+}
+
+void SlideCatalog::setShown( quint32 id, bool shown )
+{
+    if ( contains( id ) )
+        m_shown.setBit( id, shown );
+}
+
+void SlideCatalog::clearShown()
+{
+    m_shown.fill( false );
+    m_remembered.clear();
+}
+
+bool SlideCatalog::saveShown( const QString &fileName, const QString &key ) const
+{
+    QDir().mkpath( QFileInfo( fileName ).absolutePath() );
+
+    QSaveFile file( fileName );
+    if ( !file.open( QIODevice::WriteOnly ) )
+        return false;
+
+    QStringList shown = m_remembered.toList();
+    for ( int i = 0; i < m_images.count(); ++i ) {
+        if ( contains( i ) && m_shown.testBit( i ) )
+            shown.append( path( i ) );
+    }
+
+    QDataStream out( &file );
+    out << key << shown;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool SlideCatalog::loadShown( const QString &fileName, const QString &key )
+{
+    QFile file( fileName );
+    if ( !file.open( QIODevice::ReadOnly ) )
+        return false;
+
+    QString savedKey;
+    QStringList shown;
+    QDataStream in( &file );
+    in >> savedKey >> shown;
+    if ( in.status() != QDataStream::Ok || savedKey != key )
+        return false;
+
+    // Look the names up folder by folder, so a loaded catalog is only walked
+    // once.
+    QHash<QString, QSet<QByteArray> > names;
+    foreach( const QString &path, shown ) {
+        const int slash = path.lastIndexOf( '/' );
+        const QString folder = slash == 0 ? QString( '/' ) : path.left( slash );
+        if ( m_folderIds.contains( folder ) )
+            names[ folder ].insert( path.mid( slash + 1 ).toUtf8() );
+        else
+            m_remembered.insert( path );
+    }
+
+    for ( QHash<QString, QSet<QByteArray> >::iterator it = names.begin(); it != names.end(); ++it ) {
+        QSet<QByteArray> &wanted = it.value();
+        foreach( quint32 id, m_folders.at( m_folderIds.value( it.key() ) ).images ) {
+            const Image &image = m_images.at( id );
+            if ( wanted.remove( QByteArray::fromRawData( m_names.constData() + image.name,
+                                                         image.nameLength ) ) )
+                m_shown.setBit( id );
+        }
+
+        // Not in the folder yet, it may come in with the scan.
+        foreach( const QByteArray &name, wanted )
+            m_remembered.insert( it.key() == "/" ? '/' + QString::fromUtf8( name )
+                                                  : it.key() + '/' + QString::fromUtf8( name ) );
+    }
+
+    return true;
+}
+
+// Changes whenever the layout of the index file changes.
+static const quint32 indexVersion = 1;
+
+bool SlideCatalog::save( const QString &fileName, const QString &key ) const
+{
+    QDir().mkpath( QFileInfo( fileName ).absolutePath() );
+
+    QSaveFile file( fileName );
+    if ( !file.open( QIODevice::WriteOnly ) )
+        return false;
+
+    QDataStream out( &file );
+    out << indexVersion << key << quint32( m_folderIds.count() );
+    foreach( quint32 folderId, m_folderIds ) {
+        const Folder &folder = m_folders.at( folderId );
+        out << folder.path << folder.modified << quint32( folder.images.count() );
+        foreach( quint32 id, folder.images ) {
+            const Image &image = m_images.at( id );
+            out << image.nameLength;
+            out.writeRawData( m_names.constData() + image.name, image.nameLength );
+            out << image.width << image.height;
+        }
+    }
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool SlideCatalog::load( const QString &fileName, const QString &key )
+{
+    QFile file( fileName );
+    if ( !file.open( QIODevice::ReadOnly ) )
+        return false;
+
+    QDataStream in( &file );
+    quint32 version, folders;
+    QString savedKey;
+    in >> version >> savedKey >> folders;
+    if ( in.status() != QDataStream::Ok || version != indexVersion || savedKey != key )
+        return false;
+
+    clear();
+    QByteArray name;
+    for ( quint32 f = 0; f < folders && in.status() == QDataStream::Ok; ++f ) {
+        QString path;
+        qint64 modified;
+        quint32 images;
+        in >> path >> modified >> images;
+
+        const quint32 folderId = addFolder( path );
+        Folder &folder = m_folders[ folderId ];
+        folder.modified = modified;
+        for ( quint32 i = 0; i < images && in.status() == QDataStream::Ok; ++i ) {
+            quint16 length, width, height;
+            in >> length;
+            name.resize( length );
+            in.readRawData( name.data(), length );
+            in >> width >> height;
+            folder.images.append( insert( folderId, name, width, height ) );
+        }
+    }
+
+    // A broken index is worse than none.
+    if ( in.status() != QDataStream::Ok ) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+qint64 SlideCatalog::memoryUsage() const
+{
+    qint64 bytes = m_images.capacity() * sizeof( Image ) + m_free.capacity() * sizeof( quint32 ) +
+                   m_names.capacity() + m_shown.size() / 8;
+    foreach( const Folder &folder, m_folders ) {
+        bytes += sizeof( Folder ) + folder.path.capacity() * sizeof( QChar ) +
+                 folder.images.capacity() * sizeof( quint32 );
+    }
+    return bytes;
+}
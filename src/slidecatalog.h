@@ -0,0 +1,166 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_SLIDECATALOG_H
+#define RSIBREAK_SLIDECATALOG_H
+
+#include <QBitArray>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QSize>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * All images of the slideshow, kept compact enough for libraries with
+ * millions of them. Every image gets a 32-bit ID, which stays the same as
+ * long as the image is in the catalog. IDs of removed images are reused.
+ *
+ * Folders are stored once in a folder table, the file names are stored as
+ * UTF-8 one after the other in a single arena, and the size of every image
+ * takes four bytes. Whether an image was shown in the current round is kept
+ * in a bitset.
+ *
+ * The catalog can be saved to an index file together with the modification
+ * time of every folder, so only the folders which changed since then have
+ * to be read again.
+ */
+class SlideCatalog
+{
+public:
+    /** ID which is never given to an image. */
+    static const quint32 NoImage = 0xffffffff;
+
+    SlideCatalog();
+
+    /**
+     * Sets the images directly in @p folder to @p images, with @p sizes as
+     * their sizes. @p modified is the modification time of the folder when
+     * it was read. Images which were in the catalog before keep their ID.
+     * The IDs which were removed and added are appended to @p removed and
+     * @p added, in that order: an ID can be reused in the same call.
+     */
+    void setFolder( const QString &folder, qint64 modified, const QStringList &images,
+                    const QList<QSize> &sizes, QVector<quint32> *added, QVector<quint32> *removed );
+
+    /**
+     * Removes the images in @p folder and in its subfolders. Their IDs are
+     * appended to @p removed.
+     */
+    void removeFolder( const QString &folder, QVector<quint32> *removed );
+
+    /** Removes the image with @p id. */
+    void remove( quint32 id );
+
+    /** Removes all images, and forgets which ones were shown. */
+    void clear();
+
+    /** @returns the amount of images. */
+    int count() const { return m_images.count() - m_free.count(); }
+
+    bool contains( quint32 id ) const {
+        return id < uint( m_images.count() ) && m_images.at( id ).folder != NoFolder;
+    }
+
+    /** @returns the IDs of all images. */
+    QVector<quint32> images() const;
+
+    /** @returns the folders with their modification time when they were read. */
+    QHash<QString, qint64> folders() const;
+
+    /** @returns the ID of the image at @p path, or NoImage. */
+    quint32 find( const QString &path ) const;
+
+    /** @returns the path of the image with @p id. */
+    QString path( quint32 id ) const;
+
+    /** @returns the size of the image with @p id, or an invalid size when it is not known. */
+    QSize size( quint32 id ) const;
+
+    /** Whether the image with @p id was shown in the current round. */
+    bool isShown( quint32 id ) const { return id < uint( m_shown.size() ) && m_shown.testBit( id ); }
+    void setShown( quint32 id, bool shown );
+
+    /** Starts a new round. */
+    void clearShown();
+
+    /**
+     * Writes the images shown in this round to @p fileName, so the round can
+     * be continued later. @p key tells what the catalog is about.
+     */
+    bool saveShown( const QString &fileName, const QString &key ) const;
+
+    /**
+     * Continues the round saved in @p fileName, if it was saved with the same
+     * @p key. Saved images count as shown when they are added.
+     */
+    bool loadShown( const QString &fileName, const QString &key );
+
+    /**
+     * Writes all folders and images to the index file @p fileName. @p key
+     * tells what the catalog is about.
+     */
+    bool save( const QString &fileName, const QString &key ) const;
+
+    /**
+     * Replaces the catalog with the one saved in @p fileName, if it was saved
+     * with the same @p key. The IDs are not kept.
+     */
+    bool load( const QString &fileName, const QString &key );
+
+    /** @returns the amount of memory used by the catalog, in bytes. */
+    qint64 memoryUsage() const;
+
+private:
+    static const quint32 NoFolder = 0xffffffff;
+
+    struct Image {
+        quint32 folder;
+        quint32 name;       // Offset of the name in m_names.
+        quint16 nameLength;
+        quint16 width;
+        quint16 height;
+    };
+
+    struct Folder {
+        QString path;
+        qint64 modified;
+        QVector<quint32> images;
+    };
+
+    quint32 addFolder( const QString &folder );
+    quint32 insert( quint32 folder, const QByteArray &name, quint16 width, quint16 height );
+    void release( quint32 id );
+    QString fileName( const Image &image ) const;
+    void compactNames();
+
+    QVector<Image>          m_images;
+    QVector<quint32>        m_free;
+    QByteArray              m_names;
+    int                     m_unusedNames;
+
+    QVector<Folder>         m_folders;
+    QHash<QString, quint32> m_folderIds;
+
+    QBitArray               m_shown;
+
+    // Images shown in a saved round which were not added yet.
+    QSet<QString>           m_remembered;
+};
+
+#endif //RSIBREAK_SLIDECATALOG_H
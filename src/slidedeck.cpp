@@ -0,0 +1,100 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slidedeck.h"
+
+#include <algorithm>
+
+SlideDeck::SlideDeck()
+        : m_next( 0 ), m_random( std::random_device()() )
+{
+}
+
+void SlideDeck::swap( int a, int b )
+{
+    if ( a == b )
+        return;
+
+    qSwap( m_cards[ a ], m_cards[ b ] );
+    m_positions[ m_cards.at( a ) ] = a;
+    m_positions[ m_cards.at( b ) ] = b;
+}
+
+void SlideDeck::add( quint32 card, bool shown )
+{
+    if ( contains( card ) )
+        return;
+
+    if ( card >= uint( m_positions.count() ) ) {
+        const int old = m_positions.count();
+        m_positions.resize( card + 1 );
+        std::fill( m_positions.begin() + old, m_positions.end(), -1 );
+    }
+
+    m_positions[ card ] = m_cards.count();
+    m_cards.append( card );
+
+    // Shown in this round already, keep it with the shown cards.
+    if ( shown )
+        swap( m_cards.count() - 1, m_next++ );
+}
+
+void SlideDeck::remove( quint32 card )
+{
+    const int position = this->position( card );
+    if ( position == -1 )
+        return;
+
+    // Fill the hole with the last shown card, and that place with the last
+    // card, so the shown cards stay together.
+    int hole = position;
+    if ( hole < m_next ) {
+        swap( hole, m_next - 1 );
+        hole = --m_next;
+    }
+    swap( hole, m_cards.count() - 1 );
+
+    m_cards.removeLast();
+    m_positions[ card ] = -1;
+}
+
+bool SlideDeck::isShown( quint32 card ) const
+{
+    const int position = this->position( card );
+    return position != -1 && position < m_next;
+}
+
+void SlideDeck::clear()
+{
+    m_cards.clear();
+    m_positions.clear();
+    m_next = 0;
+}
+
+quint32 SlideDeck::next()
+{
+    Q_ASSERT( !m_cards.isEmpty() );
+    if ( m_cards.isEmpty() )
+        return 0;
+
+    // reset if all images are shown
+    if ( m_next >= m_cards.count() )
+        m_next = 0;
+
+    std::uniform_int_distribution<int> pick( m_next, m_cards.count() - 1 );
+    swap( m_next, pick( m_random ) );
+    return m_cards.at( m_next++ );
+}
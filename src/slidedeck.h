@@ -0,0 +1,85 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_SLIDEDECK_H
+#define RSIBREAK_SLIDEDECK_H
+
+#include <QVector>
+
+#include <random>
+
+/**
+ * Decides the order in which the slides are shown, like a shuffled deck of
+ * cards: every image is shown once before any image is shown again. Then
+ * the deck is shuffled for the next round.
+ *
+ * The cards which were not shown yet are kept together at the end, and the
+ * next one is picked at random from them (a Fisher-Yates shuffle done one
+ * step at a time). Adding, removing and drawing a card take constant time.
+ *
+ * The cards are small numbers, like the image IDs of a SlideCatalog, so
+ * the place of every card is kept in a plain array indexed by the card.
+ */
+class SlideDeck
+{
+public:
+    SlideDeck();
+
+    /**
+     * Adds @p card to the cards which are not shown yet in this round, or
+     * to the shown cards when @p shown is true.
+     */
+    void add( quint32 card, bool shown = false );
+
+    /** Removes @p card from the deck. */
+    void remove( quint32 card );
+
+    bool contains( quint32 card ) const { return position( card ) != -1; }
+
+    /** @returns true when @p card has been shown in this round. */
+    bool isShown( quint32 card ) const;
+
+    /** Removes all cards. */
+    void clear();
+
+    /** @returns the amount of cards. */
+    int count() const { return m_cards.count(); }
+
+    /** @returns the amount of cards shown in this round. */
+    int shownCount() const { return m_next; }
+
+    /**
+     * Draws the next card, and starts a new round when all cards have been
+     * shown. The deck should not be empty.
+     */
+    quint32 next();
+
+private:
+    int position( quint32 card ) const {
+        return card < uint( m_positions.count() ) ? m_positions.at( card ) : -1;
+    }
+    void swap( int a, int b );
+
+    // Cards in [0, m_next) have been shown in this round.
+    QVector<quint32>    m_cards;
+    // The place of every card in m_cards, or -1.
+    QVector<int>        m_positions;
+    int                 m_next;
+
+    std::mt19937        m_random;
+};
+
+#endif //RSIBREAK_SLIDEDECK_H
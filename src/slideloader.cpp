@@ -0,0 +1,228 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slideloader.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QRunnable>
+#include <QThread>
+
+namespace
+{
+
+class SlideJob : public QRunnable
+{
+public:
+    SlideJob( SlideLoader *loader, SlideCache *cache, int screen, int generation,
+              const QString &path, const QSize &size, Qt::AspectRatioMode mode,
+              int minimumSurface )
+            : m_loader( loader ), m_cache( cache ), m_screen( screen ), m_generation( generation ),
+              m_path( path ), m_size( size ), m_mode( mode ), m_minimumSurface( minimumSurface ) {}
+
+    void run() override {
+        bool animated = false;
+        const QImage image = SlideLoader::decode( m_path, m_size, m_mode, m_minimumSurface, m_cache,
+                                                  &animated );
+
+        // The loader waits for all jobs before it is destroyed.
+        QMetaObject::invokeMethod( m_loader, "slotDecoded", Qt::QueuedConnection,
+                                   Q_ARG( int, m_screen ),
+                                   Q_ARG( int, m_generation ),
+                                   Q_ARG( QString, m_path ),
+                                   Q_ARG( QImage, image ),
+                                   Q_ARG( bool, animated ) );
+    }
+
+private:
+    SlideLoader        *m_loader;
+    SlideCache         *m_cache;
+    int                 m_screen;
+    int                 m_generation;
+    QString             m_path;
+    QSize               m_size;
+    Qt::AspectRatioMode m_mode;
+    int                 m_minimumSurface;
+};
+
+}
+
+SlideLoader::SlideLoader( QObject *parent )
+        : QObject( parent )
+{
+    // The slides are decoded at screen size, so a few at a time is fine.
+    // With several screens each one gets a thread of its own.
+    m_pool.setMaxThreadCount( qBound( 2, QThread::idealThreadCount(), 6 ) );
+}
+
+SlideLoader::~SlideLoader()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+SlideLoader::Screen &SlideLoader::screen( int index )
+{
+    if ( index >= m_screens.count() )
+        m_screens.resize( index + 1 );
+    return m_screens[ index ];
+}
+
+void SlideLoader::setTarget( const QSize &size, Qt::AspectRatioMode mode, int minimumSurface,
+                             int index )
+{
+    Screen &s = screen( index );
+    if ( size == s.size && mode == s.mode && minimumSurface == s.minimumSurface )
+        return;
+
+    s.slides.clear();
+    s.inProgress = 0;
+    ++s.generation;
+    s.size = size;
+    s.mode = mode;
+    s.minimumSurface = minimumSurface;
+}
+
+void SlideLoader::prepare( const QString &path, int index )
+{
+    Screen &s = screen( index );
+    ++s.inProgress;
+    m_pool.start( new SlideJob( this, &m_cache, index, s.generation, path,
+                                s.size, s.mode, s.minimumSurface ) );
+}
+
+int SlideLoader::pending( int index ) const
+{
+    if ( index >= m_screens.count() )
+        return 0;
+
+    const Screen &s = m_screens.at( index );
+    return s.slides.count() + s.inProgress;
+}
+
+bool SlideLoader::hasSlide( int index ) const
+{
+    return index < m_screens.count() && !m_screens.at( index ).slides.isEmpty();
+}
+
+QImage SlideLoader::takeSlide( int index, QString *animation, QString *path )
+{
+    if ( !hasSlide( index ) )
+        return QImage();
+
+    const Slide slide = m_screens[ index ].slides.dequeue();
+    if ( animation )
+        *animation = slide.animated ? slide.path : QString();
+    if ( path )
+        *path = slide.path;
+    return slide.image;
+}
+
+void SlideLoader::clear()
+{
+    m_pool.clear();
+    for ( int i = 0; i < m_screens.count(); ++i ) {
+        Screen &s = m_screens[ i ];
+        s.slides.clear();
+        s.inProgress = 0;
+        ++s.generation;
+    }
+}
+
+qint64 SlideLoader::memoryUsage() const
+{
+    qint64 bytes = 0;
+    foreach( const Screen &s, m_screens ) {
+        foreach( const Slide &slide, s.slides )
+            bytes += slide.image.byteCount();
+    }
+    return bytes;
+}
+
+QImage SlideLoader::decode( const QString &path, const QSize &size,
+                            Qt::AspectRatioMode mode, int minimumSurface,
+                            SlideCache *cache, bool *animated )
+{
+    if ( animated )
+        *animated = false;
+
+    const SlideCache::Target target = { size, mode, minimumSurface };
+    const QDateTime modified = QFileInfo( path ).lastModified();
+    if ( cache ) {
+        const QImage slide = cache->find( path, modified, target );
+        if ( !slide.isNull() )
+            return slide;
+    }
+
+    qDebug() << "Loading:" << path;
+
+    QImageReader reader( path );
+    // The count is 0 when the format does not know it up front.
+    const bool moving = reader.supportsAnimation() && reader.imageCount() != 1;
+    const QSize original = reader.size();
+    if ( original.isValid() ) {
+        // Check size
+        if ( original.width() * original.height() < minimumSurface )
+            return QImage();
+
+        // Let the decoder produce the slide size right away, a JPEG is then
+        // decoded at a fraction of its resolution.
+        reader.setScaledSize( original.scaled( size, mode ) );
+    }
+
+    QImage slide = reader.read();
+    if ( slide.isNull() )
+        return QImage();
+
+    // The format could not tell its size up front.
+    if ( !original.isValid() ) {
+        if ( slide.width() * slide.height() < minimumSurface )
+            return QImage();
+        slide = slide.scaled( size, mode );
+    }
+
+    // Animations are played from the original, so a slide found in the
+    // cache is always a still one.
+    if ( animated )
+        *animated = moving;
+    if ( cache && !moving )
+        cache->insert( path, modified, target, slide );
+
+    return slide;
+}
+
+void SlideLoader::slotDecoded( int index, int generation, const QString &path, const QImage &image,
+                               bool animated )
+{
+    Screen &s = screen( index );
+    if ( generation != s.generation )
+        return;
+
+    --s.inProgress;
+
+    if ( image.isNull() ) {
+        emit rejected( path );
+        return;
+    }
+
+    Slide slide;
+    slide.image = image;
+    slide.path = path;
+    slide.animated = animated;
+    s.slides.enqueue( slide );
+    emit slideReady( index );
+}
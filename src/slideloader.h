@@ -0,0 +1,132 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_SLIDELOADER_H
+#define RSIBREAK_SLIDELOADER_H
+
+#include <QImage>
+#include <QObject>
+#include <QQueue>
+#include <QSize>
+#include <QThreadPool>
+#include <QVector>
+
+#include "slidecache.h"
+
+/**
+ * Prepares slides for the SlideEffect on a pool of worker threads, ahead of
+ * the time they are shown. Images are decoded and scaled to the target
+ * size in the background and wait in a queue, so the GUI thread only has
+ * to swap them in. Scaled slides are kept in a SlideCache on disk.
+ *
+ * Every screen showing slides has its own target and queue, the screens
+ * share the worker threads so their slides are decoded in parallel.
+ */
+class SlideLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SlideLoader( QObject *parent = 0 );
+    ~SlideLoader();
+
+    /**
+     * Sets the size the slides for @p screen are scaled to, and the smallest
+     * surface an image needs to have to be shown at all. Slides prepared for
+     * another target are dropped.
+     */
+    void setTarget( const QSize &size, Qt::AspectRatioMode mode, int minimumSurface,
+                    int screen = 0 );
+
+    /** Queues the image at @p path to be prepared in the background. */
+    void prepare( const QString &path, int screen = 0 );
+
+    /** @returns the amount of slides which are ready or being prepared. */
+    int pending( int screen = 0 ) const;
+
+    /** @returns true when a prepared slide is waiting. */
+    bool hasSlide( int screen = 0 ) const;
+
+    /**
+     * Takes the oldest prepared slide from the queue. When the image has
+     * more frames @p animation is set to its path, to play it with a
+     * SlideAnimation, otherwise it is cleared. @p path is set to the path
+     * of the image.
+     */
+    QImage takeSlide( int screen = 0, QString *animation = 0, QString *path = 0 );
+
+    /** Drops all prepared slides and the ones still being prepared. */
+    void clear();
+
+    /** @returns the memory taken by the prepared slides, in bytes. */
+    qint64 memoryUsage() const;
+
+    /**
+     * Loads the image at @p path and scales it to @p size. When the format
+     * supports it, the image is decoded at the reduced size directly instead
+     * of decoding it at full size first. When a @p cache is given, a slide
+     * scaled before is taken from it, or the new one is stored in it. Safe
+     * to call from any thread. @p animated is set when the image has more
+     * frames, those are never cached.
+     * @returns a null image when it could not be loaded, or when its
+     * surface is smaller than @p minimumSurface.
+     */
+    static QImage decode( const QString &path, const QSize &size,
+                          Qt::AspectRatioMode mode, int minimumSurface,
+                          SlideCache *cache = 0, bool *animated = 0 );
+
+signals:
+    /** A slide for @p screen has been prepared, it can be taken now. */
+    void slideReady( int screen );
+
+    /** The image at @p path could not be loaded, or is too small. */
+    void rejected( const QString &path );
+
+private slots:
+    void slotDecoded( int screen, int generation, const QString &path, const QImage &image,
+                      bool animated );
+
+private:
+    struct Slide {
+        QImage  image;
+        QString path;
+        bool    animated;
+    };
+
+    struct Screen {
+        Screen() : inProgress( 0 ), generation( 0 ), mode( Qt::KeepAspectRatio ),
+            minimumSurface( 0 ) {}
+
+        QQueue<Slide>       slides;
+        int                 inProgress;
+
+        // Increased when the target changes, results of older jobs are
+        // ignored.
+        int                 generation;
+
+        QSize               size;
+        Qt::AspectRatioMode mode;
+        int                 minimumSurface;
+    };
+
+    Screen &screen( int index );
+
+    SlideCache          m_cache;
+    QThreadPool         m_pool;
+    QVector<Screen>     m_screens;
+};
+
+#endif //RSIBREAK_SLIDELOADER_H
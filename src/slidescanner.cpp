@@ -0,0 +1,264 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slidescanner.h"
+
+#include <QDebug>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QRunnable>
+
+namespace
+{
+
+class ScanJob : public QRunnable
+{
+public:
+    ScanJob( SlideScanner *scanner, const QAtomicInt *current, int generation,
+             const QStringList &folders, bool recursive, const QHash<QString, qint64> &known )
+            : m_scanner( scanner ), m_current( current ), m_generation( generation ),
+              m_folders( folders ), m_recursive( recursive ), m_known( known ) {}
+
+    void run() override {
+        const QStringList filters = SlideScanner::nameFilters();
+
+        // Stop as soon as a new scan has been started.
+        while ( !m_folders.isEmpty() && m_current->load() == m_generation ) {
+            const QString folder = m_folders.takeFirst();
+            QStringList images;
+            QList<QSize> sizes;
+            QStringList subfolders;
+
+            QDir dir( folder );
+            const bool exists = dir.exists() && dir.isReadable();
+            const qint64 modified = exists ? QFileInfo( folder ).lastModified().toMSecsSinceEpoch() : 0;
+            const bool changed = !m_known.contains( folder ) || m_known.value( folder ) != modified;
+            if ( exists && !changed ) {
+                // The images are known already, only the subfolders may
+                // have changed.
+                if ( m_recursive ) {
+                    dir.setFilter( QDir::AllDirs | QDir::NoSymLinks | QDir::NoDotAndDotDot );
+                    const QStringList list = dir.entryList();
+                    for ( int i = 0; i < list.count(); ++i )
+                        subfolders.append( dir.absoluteFilePath( list.at( i ) ) );
+                    m_folders += subfolders;
+                }
+            } else if ( exists ) {
+                dir.setNameFilters( filters );
+                dir.setFilter( QDir::Dirs | QDir::Files | QDir::NoSymLinks | QDir::AllDirs |
+                               QDir::NoDotAndDotDot );
+
+                const QFileInfoList list = dir.entryInfoList();
+                for ( int i = 0; i < list.count(); ++i ) {
+                    const QFileInfo &fi = list.at( i );
+                    if ( fi.isFile() ) {
+                        images.append( fi.filePath() );
+                        // Only reads the header.
+                        sizes.append( QImageReader( fi.filePath() ).size() );
+                    } else if ( fi.isDir() )
+                        subfolders.append( fi.absoluteFilePath() );
+                }
+
+                if ( m_recursive )
+                    m_folders += subfolders;
+            } else {
+                qWarning() << "Folder does not exist or is not readable: " << folder;
+            }
+
+            QMetaObject::invokeMethod( m_scanner, "slotFolderRead", Qt::QueuedConnection,
+                                       Q_ARG( int, m_generation ),
+                                       Q_ARG( QString, folder ),
+                                       Q_ARG( bool, exists ),
+                                       Q_ARG( bool, m_recursive ),
+                                       Q_ARG( bool, changed ),
+                                       Q_ARG( qint64, modified ),
+                                       Q_ARG( QStringList, images ),
+                                       Q_ARG( QList<QSize>, sizes ),
+                                       Q_ARG( QStringList, subfolders ) );
+        }
+
+        QMetaObject::invokeMethod( m_scanner, "slotJobDone", Qt::QueuedConnection,
+                                   Q_ARG( int, m_generation ) );
+    }
+
+private:
+    SlideScanner     *m_scanner;
+    const QAtomicInt *m_current;
+    int               m_generation;
+    QStringList       m_folders;
+    bool              m_recursive;
+    const QHash<QString, qint64> m_known;
+};
+
+}
+
+SlideScanner::SlideScanner( QObject *parent )
+        : QObject( parent ), m_generation( 0 ), m_running( 0 ), m_recursive( false )
+{
+    qRegisterMetaType< QList<QSize> >( "QList<QSize>" );
+    m_pool.setMaxThreadCount( 2 );
+
+    m_watcher = new QFileSystemWatcher( this );
+    connect( m_watcher, &QFileSystemWatcher::directoryChanged, this, &SlideScanner::slotDirectoryChanged );
+
+    // Copying a bunch of images changes a folder many times in a row, read
+    // it once things have calmed down.
+    m_rescanTimer = new QTimer( this );
+    m_rescanTimer->setSingleShot( true );
+    m_rescanTimer->setInterval( 1000 );
+    connect( m_rescanTimer, &QTimer::timeout, this, &SlideScanner::slotRescan );
+}
+
+SlideScanner::~SlideScanner()
+{
+    m_generation.ref();
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QStringList SlideScanner::nameFilters()
+{
+    // TODO: make an automated filter, maybe with QImageIO.
+    QStringList filters;
+    filters << "*.png" << "*.jpg" << "*.jpeg" << "*.tif" << "*.tiff" <<
+    "*.gif" << "*.bmp" << "*.xpm" << "*.ppm" <<  "*.pnm"  << "*.xcf" <<
+    "*.pcx" << "*.webp" << "*.apng" << "*.mng";
+    QStringList filtersUp;
+    for ( int i = 0; i < filters.size(); ++i )
+        filtersUp << filters.at( i ).toUpper();
+    return filters << filtersUp;
+}
+
+void SlideScanner::start( const QString &folder, bool recursive,
+                          const QHash<QString, qint64> &known )
+{
+    stop();
+
+    m_recursive = recursive;
+    m_known = known;
+    if ( !folder.isEmpty() )
+        scan( QStringList() << QDir::cleanPath( folder ), recursive, known );
+}
+
+void SlideScanner::stop()
+{
+    m_generation.ref();
+    m_pool.clear();
+    m_running = 0;
+
+    m_rescanTimer->stop();
+    m_changed.clear();
+    m_known.clear();
+
+    if ( !m_folders.isEmpty() )
+        m_watcher->removePaths( m_folders.toList() );
+    m_folders.clear();
+}
+
+void SlideScanner::scan( const QStringList &folders, bool recursive,
+                         const QHash<QString, qint64> &known )
+{
+    ++m_running;
+    m_pool.start( new ScanJob( this, &m_generation, m_generation.load(), folders, recursive,
+                               known ) );
+}
+
+void SlideScanner::forget( const QString &folder )
+{
+    const QString prefix = folder + '/';
+
+    QStringList gone;
+    foreach( const QString &f, m_folders ) {
+        if ( f == folder || f.startsWith( prefix ) )
+            gone.append( f );
+    }
+
+    foreach( const QString &f, gone )
+        m_folders.remove( f );
+    if ( !gone.isEmpty() )
+        m_watcher->removePaths( gone );
+}
+
+void SlideScanner::slotFolderRead( int generation, const QString &folder, bool exists, bool recursive,
+                                   bool changed, qint64 modified, const QStringList &images,
+                                   const QList<QSize> &sizes, const QStringList &subfolders )
+{
+    if ( generation != m_generation.load() )
+        return;
+
+    const bool known = m_known.remove( folder ) > 0;
+    if ( !exists ) {
+        if ( m_folders.contains( folder ) || known ) {
+            forget( folder );
+            emit folderRemoved( folder );
+        }
+        return;
+    }
+
+    if ( !m_folders.contains( folder ) ) {
+        m_folders.insert( folder );
+        m_watcher->addPath( folder );
+    }
+
+    // A folder which was read again because it changed may have new
+    // subfolders, the scan did not enter them.
+    if ( m_recursive && !recursive ) {
+        QStringList added;
+        foreach( const QString &f, subfolders ) {
+            if ( !m_folders.contains( f ) )
+                added.append( f );
+        }
+        if ( !added.isEmpty() )
+            scan( added, true );
+    }
+
+    if ( changed )
+        emit folderScanned( folder, images, sizes, modified );
+}
+
+void SlideScanner::slotJobDone( int generation )
+{
+    if ( generation != m_generation.load() )
+        return;
+
+    if ( --m_running > 0 )
+        return;
+
+    // The known folders which were not seen are gone.
+    QStringList gone = m_known.keys();
+    m_known.clear();
+    foreach( const QString &folder, gone )
+        emit folderRemoved( folder );
+
+    emit finished();
+}
+
+void SlideScanner::slotDirectoryChanged( const QString &folder )
+{
+    m_changed.insert( folder );
+    m_rescanTimer->start();
+}
+
+void SlideScanner::slotRescan()
+{
+    if ( m_changed.isEmpty() )
+        return;
+
+    scan( m_changed.toList(), false );
+    m_changed.clear();
+}
@@ -0,0 +1,112 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_SLIDESCANNER_H
+#define RSIBREAK_SLIDESCANNER_H
+
+#include <QAtomicInt>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QSize>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+
+/**
+ * Finds the images for the SlideEffect in the background. Every folder is
+ * reported as soon as it has been read, so the first slide can be shown
+ * long before a large collection has been scanned completely. The size of
+ * each image is read from its header, without decoding it.
+ *
+ * Afterwards the scanned folders are watched, and only the folders which
+ * change are read again. Folders which were read before, for example by an
+ * earlier run, are not read again if they did not change since then.
+ */
+class SlideScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SlideScanner( QObject *parent = 0 );
+    ~SlideScanner();
+
+    /**
+     * Starts scanning @p folder, and its subfolders when @p recursive is
+     * true. A scan which is still running is abandoned, and all folders
+     * which were watched are forgotten.
+     *
+     * @p known are folders which were read before, with their modification
+     * time at that moment. They are only read again when they were modified
+     * since, and reported as removed when they are not found.
+     */
+    void start( const QString &folder, bool recursive,
+                const QHash<QString, qint64> &known = QHash<QString, qint64>() );
+
+    /** Stops scanning and watching. */
+    void stop();
+
+    /** @returns true while folders are being read. */
+    bool isScanning() const { return m_running > 0; }
+
+    /** @returns the file name patterns of the images which are found. */
+    static QStringList nameFilters();
+
+signals:
+    /**
+     * @p folder has been read, @p images are all the images directly in it
+     * and @p sizes their sizes, or an invalid size when it is not known.
+     * @p modified is the modification time of the folder, in milliseconds
+     * since the epoch. This is emitted again with the new contents when the
+     * folder changes.
+     */
+    void folderScanned( const QString &folder, const QStringList &images,
+                        const QList<QSize> &sizes, qint64 modified );
+
+    /** @p folder and everything in it has been removed. */
+    void folderRemoved( const QString &folder );
+
+    /** All folders have been read. */
+    void finished();
+
+private slots:
+    void slotFolderRead( int generation, const QString &folder, bool exists, bool recursive,
+                         bool changed, qint64 modified, const QStringList &images,
+                         const QList<QSize> &sizes, const QStringList &subfolders );
+    void slotJobDone( int generation );
+    void slotDirectoryChanged( const QString &folder );
+    void slotRescan();
+
+private:
+    void scan( const QStringList &folders, bool recursive,
+               const QHash<QString, qint64> &known = QHash<QString, qint64>() );
+    void forget( const QString &folder );
+
+    QThreadPool         m_pool;
+    QFileSystemWatcher *m_watcher;
+    QTimer             *m_rescanTimer;
+    QAtomicInt          m_generation;
+    int                 m_running;
+    bool                m_recursive;
+    QSet<QString>       m_folders;
+    QSet<QString>       m_changed;
+    // Known folders which have not been seen by the running scan.
+    QHash<QString, qint64> m_known;
+};
+
+#endif //RSIBREAK_SLIDESCANNER_H
@@ -19,191 +19,487 @@
 
 #include "slideshoweffect.h"
 #include "breakbase.h"
+#include "rsiglobals.h"
+#include "rsitransition.h"
+#include "slideanimation.h"
+#include "slideloader.h"
+#include "slidescanner.h"
 
 #include <QApplication>
 #include <QDebug>
 #include <QDesktopWidget>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QRunnable>
+#include <QStandardPaths>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QLabel>
 
-#include <KWindowSystem>
+#include <climits>
 
+namespace
+{
 
-SlideEffect::SlideEffect( QObject *parent )
-        : BreakBase( parent ), m_searchRecursive( false ), m_showSmallImages( false )
+class BlendJob : public QRunnable
 {
-    // Make all other screens gray...
-    slotGray();
-    connect( QApplication::desktop(), &QDesktopWidget::screenCountChanged, this, &SlideEffect::slotGray );
+public:
+    BlendJob( QObject *widget, const QAtomicInt *current, int generation, const QImage &from,
+              const QImage &to, const QSize &size, const QColor &background, int frames )
+            : m_widget( widget ), m_current( current ), m_generation( generation ), m_from( from ), m_to( to ),
+              m_size( size ), m_background( background ), m_frames( frames ) {}
+
+    void run() override {
+        // Both images are centered, like the label shows them.
+        const QPoint from( ( m_size.width() - m_from.width() ) / 2, ( m_size.height() - m_from.height() ) / 2 );
+        const QPoint to( ( m_size.width() - m_to.width() ) / 2, ( m_size.height() - m_to.height() ) / 2 );
+
+        // Stop as soon as the cross-fade was cut short, so the next one does
+        // not wait behind frames which are thrown away.
+        for ( int i = 0; i < m_frames && m_current->load() == m_generation; ++i ) {
+            QElapsedTimer timer;
+            timer.start();
+
+            const qreal progress = qreal( i + 1 ) / ( m_frames + 1 );
+            QImage frame( m_size, QImage::Format_ARGB32_Premultiplied );
+            frame.fill( m_background );
+            QPainter p( &frame );
+            p.setOpacity( 1 - progress );
+            p.drawImage( from, m_from );
+            p.setOpacity( progress );
+            p.drawImage( to, m_to );
+            p.end();
+
+            // The widget waits for all jobs before it is destroyed.
+            QMetaObject::invokeMethod( m_widget, "slotBlended", Qt::QueuedConnection,
+                                       Q_ARG( int, m_generation ),
+                                       Q_ARG( int, i ),
+                                       Q_ARG( QImage, frame ),
+                                       Q_ARG( qint64, timer.nsecsElapsed() / 1000 ) );
+        }
+    }
+
+private:
+    QObject *m_widget;
+    const QAtomicInt *m_current;
+    int      m_generation;
+    QImage   m_from;
+    QImage   m_to;
+    QSize    m_size;
+    QColor   m_background;
+    int      m_frames;
+};
 
-    m_slidewidget = new SlideWidget( 0 );
-    KWindowSystem::forceActiveWindow( m_slidewidget->winId() );
-    KWindowSystem::setOnAllDesktops( m_slidewidget->winId(), true );
-    KWindowSystem::setState( m_slidewidget->winId(), NET::KeepAbove );
-    KWindowSystem::setState( m_slidewidget->winId(), NET::FullScreen );
+}
 
+
+SlideEffect::SlideEffect( QObject *parent )
+        : BreakBase( parent ), m_slideShown( false ), m_active( false ), m_grayAllScreens( false ),
+          m_allScreens( false ), m_indexDirty( false ), m_searchRecursive( false ), m_showSmallImages( false ),
+          m_expandImageToFullScreen( false ), m_slideInterval( 0 )
+{
     setReadOnly( true );
 
     m_timer_slide = new QTimer( this );
     connect(m_timer_slide, &QTimer::timeout, this, &SlideEffect::slotNewSlide);
+
+    m_loader = new SlideLoader( this );
+    connect( m_loader, &SlideLoader::slideReady, this, &SlideEffect::slotSlideReady );
+    connect( m_loader, &SlideLoader::rejected, this, &SlideEffect::slotRejected );
+
+    m_scanner = new SlideScanner( this );
+    connect( m_scanner, &SlideScanner::folderScanned, this, &SlideEffect::slotFolderScanned );
+    connect( m_scanner, &SlideScanner::folderRemoved, this, &SlideEffect::slotFolderRemoved );
+    connect( m_scanner, &SlideScanner::finished, this, &SlideEffect::slotScanFinished );
+
+    // Make all other screens gray...
+    setGrayEffectOnAllScreens( true );
+    screensChanged();
 }
 
 SlideEffect::~SlideEffect()
 {
-    delete m_slidewidget;
+    // The next run starts from this catalog.
+    if ( m_indexDirty )
+        m_catalog.save( indexFile(), m_basePath );
+    qDeleteAll( m_slidewidgets );
 }
 
 void SlideEffect::slotGray()
 {
     // Make all other screens gray...
-    setGrayEffectOnAllScreens( true );
-    excludeGrayEffectOnScreen( QApplication::desktop()->primaryScreen() );
+    QSet<int> screens;
+    foreach( SlideWidget* widget, m_slidewidgets )
+        screens.insert( widget->screen() );
+    setGrayEffectExcludedScreens( screens );
+}
+
+void SlideEffect::screensChanged()
+{
+    QDesktopWidget *desktop = QApplication::desktop();
+
+    QList<int> screens;
+    if ( m_allScreens ) {
+        for ( int i = 0; i < desktop->screenCount(); ++i )
+            screens << i;
+    } else {
+        screens << desktop->primaryScreen();
+    }
+
+    // Keep the windows when the same screens show slides, the loader
+    // prepares new slides when their size changed.
+    QList<int> current;
+    foreach( SlideWidget* widget, m_slidewidgets )
+        current << widget->screen();
+
+    if ( screens != current ) {
+        qDeleteAll( m_slidewidgets );
+        m_slidewidgets.clear();
+        foreach( int screen, screens ) {
+            SlideWidget *widget = new SlideWidget( screen );
+            setupWindow( widget );
+            m_slidewidgets.append( widget );
+        }
+
+        m_loader->clear();
+        m_slideShown = false;
+    }
+    slotGray();
+    loadImage();
 }
 
 bool SlideEffect::hasImages()
 {
-    return m_files.count() > 0;
+    return m_deck.count() > 0;
 }
 
 void SlideEffect::activate()
 {
-    m_slidewidget->show();
+    m_active = true;
+
+    // Nothing is prepared anymore when the resources were released.
+    loadImage();
+
+    if ( m_slideShown ) {
+        foreach( SlideWidget* widget, m_slidewidgets )
+            showWidget( widget );
+    } else {
+        // The images are still being searched, gray out these screens too.
+        setGrayEffectExcludedScreens( QSet<int>() );
+        m_grayAllScreens = true;
+    }
     m_timer_slide->start( m_slideInterval*1000 );
     BreakBase::activate();
 }
 
 void SlideEffect::deactivate()
 {
+    m_active = false;
     m_timer_slide->stop();
-    m_slidewidget->hide();
+    foreach( SlideWidget* widget, m_slidewidgets )
+        widget->hide();
     BreakBase::deactivate();
+
+    m_catalog.saveShown( deckFile(), m_basePath );
+
+    if ( m_grayAllScreens ) {
+        slotGray();
+        m_grayAllScreens = false;
+    }
 }
 
+// Number of slides which are prepared ahead of time.
+static const int prefetchDepth = 3;
+
 void SlideEffect::loadImage()
 {
-    if ( m_files.count() == 0 )
-        return;
+    QDesktopWidget *desktop = QApplication::desktop();
+    const Qt::AspectRatioMode mode = ( m_expandImageToFullScreen ) ? Qt::KeepAspectRatioByExpanding
+                                                             : Qt::KeepAspectRatio;
+    const int minimum = minimumSurface();
 
-    // Base the size on the size of the screen, for xinerama.
-    QRect size = QApplication::desktop()->screenGeometry(
-                     QApplication::desktop()->primaryScreen() );
+    // Base the size on the size of the screen, for xinerama. Images of which
+    // the size was not known during the scan are checked after decoding.
+    for ( int i = 0; i < m_slidewidgets.count(); ++i ) {
+        const QRect size = desktop->screenGeometry( m_slidewidgets.at( i )->screen() );
+        m_loader->setTarget( size.size(), mode, minimum, i );
+    }
 
-    // Do not accept images whose surface is more than 3 times smaller than
-    // screen
-    int min_image_surface = size.width() * size.height() / 3;
-    QImage image;
-
-    while ( true ) {
-        // reset if all images are shown
-        if ( m_files_done.count() == m_files.count() )
-            m_files_done.clear();
-
-        // get a not yet used image
-        int j;
-        QString name;
-        do {
-            j = ( int )( m_files.count() * ( rand() / ( RAND_MAX + 1.0 ) ) );
-            name = m_files[ j ];
-        } while ( m_files_done.indexOf( name ) != -1 );
-
-        // load image
-        qDebug() << "Loading:" << name << "(" << j << "/"  << m_files.count() << ") ";
-        image.load( name );
-
-        // Check size
-        if ( image.width() * image.height() >= min_image_surface || m_showSmallImages ) {
-            // Image is big enough, leave while loop
-            m_files_done.append( name );
-            break;
-        } else {
-            // Too small, remove from list
-            m_files.removeAll( name );
-            if ( m_files.count() == 0 ) {
-                // Couldn't find any image big enough, leave function
-                return;
-            }
+    // Keep the queues of the loader filled, the images are decoded and
+    // scaled in the background. Take turns, so the first slides of all
+    // screens are decoded at the same time.
+    const int depth = qMin( prefetchDepth, m_deck.count() );
+    for ( int d = 1; d <= depth; ++d ) {
+        for ( int i = 0; i < m_slidewidgets.count(); ++i ) {
+            if ( m_loader->pending( i ) < d )
+                m_loader->prepare( nextImage(), i );
         }
     }
+}
 
-    const Qt::AspectRatioMode mode = ( m_expandImageToFullScreen ) ? Qt::KeepAspectRatioByExpanding
-                                                             : Qt::KeepAspectRatio;
-    const QImage m( image.scaled( size.width(), size.height(), mode ) );
+QString SlideEffect::nextImage()
+{
+    // The deck starts a new round, so does the catalog.
+    if ( m_deck.shownCount() >= m_deck.count() )
+        m_catalog.clearShown();
+
+    // Marked as shown in the catalog once it is on screen, the slides
+    // which are prepared ahead may never be.
+    return m_catalog.path( m_deck.next() );
+}
+
+void SlideEffect::slotSlideReady( int screen )
+{
+    // Show the first slide of a screen as soon as it is there.
+    if ( screen < m_slidewidgets.count() && !m_slidewidgets.at( screen )->hasImage() ) {
+        showSlide( screen );
+        loadImage();
+    }
+}
 
-    if ( m.isNull() )
+void SlideEffect::showSlide( int index )
+{
+    // Only swap in a slide which is ready, never wait for one.
+    if ( !m_loader->hasSlide( index ) )
         return;
 
-    m_slidewidget->setImage( m );
+    SlideWidget *widget = m_slidewidgets.at( index );
+    QString animation;
+    QString path;
+    const QImage slide = m_loader->takeSlide( index, &animation, &path );
+    widget->setImage( slide, animation );
+    m_catalog.setShown( m_catalog.find( path ), true );
+    m_slideShown = true;
+
+    if ( m_active && !widget->isVisible() )
+        showWidget( widget );
 }
 
+void SlideEffect::showWidget( SlideWidget *widget )
+{
+    // The window is created again after it was released.
+    if ( !widget->testAttribute( Qt::WA_WState_Created ) )
+        setupWindow( widget );
+    widget->show();
+}
 
-void SlideEffect::findImagesInFolder( const QString& folder )
+void SlideEffect::prepare()
 {
-    if ( folder.isNull() )
-        return;
+    BreakBase::prepare();
 
-    QDir dir( folder );
+    // Decode the first slides now, and create the windows while hidden.
+    loadImage();
+    foreach( SlideWidget* widget, m_slidewidgets ) {
+        if ( !widget->testAttribute( Qt::WA_WState_Created ) )
+            setupWindow( widget );
+    }
+}
 
-    if ( !dir.exists() || !dir.isReadable() ) {
-        qWarning() << "Folder does not exist or is not readable: "
-        << folder << endl;
-        return;
+void SlideEffect::releaseResources()
+{
+    BreakBase::releaseResources();
+
+    // The slides are prepared again for the next break.
+    foreach( SlideWidget* widget, m_slidewidgets )
+        widget->release();
+    m_loader->clear();
+    m_slideShown = false;
+}
+
+void SlideEffect::retire()
+{
+    // Stop watching the folders, reset() scans them again like the first
+    // time when the slideshow is chosen again.
+    m_scanner->stop();
+    if ( m_indexDirty )
+        m_catalog.save( indexFile(), m_basePath );
+    m_indexDirty = false;
+
+    m_loader->clear();
+    m_slideShown = false;
+    m_catalog.clear();
+    m_deck.clear();
+    m_basePath.clear();
+}
+
+void SlideEffect::reportMemory( QMap<QString, qint64> &report ) const
+{
+    BreakBase::reportMemory( report );
+
+    qint64 windows = 0, images = 0;
+    foreach( SlideWidget* widget, m_slidewidgets ) {
+        windows += windowMemory( widget );
+        images += widget->imageMemory();
+    }
+    report.insert( "slideWindows", windows );
+    report.insert( "slideImages", images );
+    report.insert( "preparedSlides", m_loader->memoryUsage() );
+    report.insert( "catalog", m_catalog.memoryUsage() );
+}
+
+void SlideEffect::slotRejected( const QString& name )
+{
+    // Too small or unreadable, remove from the deck
+    m_deck.remove( m_catalog.find( name ) );
+    loadImage();
+}
+
+int SlideEffect::minimumSurface() const
+{
+    if ( m_showSmallImages )
+        return 0;
+
+    // Do not accept images whose surface is more than 3 times smaller than
+    // screen, the smallest one when showing on all screens.
+    int surface = INT_MAX;
+    foreach( SlideWidget* widget, m_slidewidgets ) {
+        const QRect size = QApplication::desktop()->screenGeometry( widget->screen() );
+        surface = qMin( surface, size.width() * size.height() / 3 );
     }
+    return surface == INT_MAX ? 0 : surface;
+}
+
+bool SlideEffect::isLargeEnough( quint32 id, int minimumSurface ) const
+{
+    // The size was read from the header, when it is not known the image is
+    // checked after decoding.
+    const QSize size = m_catalog.size( id );
+    return !size.isValid() || size.width() * size.height() >= minimumSurface;
+}
+
+void SlideEffect::slotFolderScanned( const QString& folder, const QStringList& images,
+                                     const QList<QSize>& sizes, qint64 modified )
+{
+    // Only touch the images which came or went, the others keep their ID
+    // and their place in the deck.
+    QVector<quint32> added, removed;
+    m_catalog.setFolder( folder, modified, images, sizes, &added, &removed );
+    m_indexDirty = true;
+    foreach( quint32 id, removed )
+        m_deck.remove( id );
+
+    // Leave out the images which are too small before they are ever
+    // decoded. They stay in the catalog, for when small images are wanted.
+    const int minimum = minimumSurface();
+    foreach( quint32 id, added ) {
+        if ( isLargeEnough( id, minimum ) )
+            m_deck.add( id, m_catalog.isShown( id ) );
+    }
+
+    // Start preparing slides as soon as the first images are found.
+    loadImage();
+}
 
-    // TODO: make an automated filter, maybe with QImageIO.
-    QStringList filters;
-    filters << "*.png" << "*.jpg" << "*.jpeg" << "*.tif" << "*.tiff" <<
-    "*.gif" << "*.bmp" << "*.xpm" << "*.ppm" <<  "*.pnm"  << "*.xcf" <<
-    "*.pcx";
-    QStringList filtersUp;
-    for ( int i = 0; i < filters.size(); ++i )
-        filtersUp << filters.at( i ).toUpper();
-    dir.setNameFilters( filters << filtersUp );
-    dir.setFilter( QDir::Dirs | QDir::Files | QDir::NoSymLinks | QDir::AllDirs );
+void SlideEffect::slotFolderRemoved( const QString& folder )
+{
+    QVector<quint32> removed;
+    m_catalog.removeFolder( folder, &removed );
+    m_indexDirty = true;
+    foreach( quint32 id, removed )
+        m_deck.remove( id );
+}
 
-    const QFileInfoList list = dir.entryInfoList();
-    for ( int i = 0; i < list.count(); ++i ) {
-        QFileInfo fi = list.at( i );
-        if ( fi.isFile() )
-            m_files.append( fi.filePath() );
-        else if ( fi.isDir() && m_searchRecursive &&
-                  fi.fileName() != "." &&  fi.fileName() != ".." )
-            findImagesInFolder( fi.absoluteFilePath() );
+void SlideEffect::slotScanFinished()
+{
+    if ( m_indexDirty ) {
+        m_catalog.save( indexFile(), m_basePath );
+        m_indexDirty = false;
     }
 }
 
+QString SlideEffect::indexFile()
+{
+    return QStandardPaths::writableLocation( QStandardPaths::CacheLocation ) + "/slidecatalog";
+}
+
+QString SlideEffect::deckFile()
+{
+    return QStandardPaths::writableLocation( QStandardPaths::DataLocation ) + "/slidedeck";
+}
+
 void SlideEffect::slotNewSlide()
 {
-    if ( m_files.count() == 1 )
+    if ( m_deck.count() == 1 && m_slideShown )
         return;
 
+    for ( int i = 0; i < m_slidewidgets.count(); ++i )
+        showSlide( i );
+
     loadImage();
 }
 
-void SlideEffect::reset( const QString& path, bool recursive, bool showSmallImages, bool expandImageToFullScreen, int slideInterval )
+void SlideEffect::reset( const QString& path, bool recursive, bool showSmallImages, bool expandImageToFullScreen, int slideInterval,
+                         bool allScreens )
 {
-    m_files.clear();
-    m_files_done.clear();
-    m_basePath = path;
-    m_searchRecursive = recursive;
-    m_showSmallImages = showSmallImages;
+    // The settings are applied again whenever the configuration changes,
+    // only rebuild what depends on the ones which changed.
+    const bool rescan = path != m_basePath || recursive != m_searchRecursive;
+    const bool refilter = showSmallImages != m_showSmallImages;
+    const bool rescale = expandImageToFullScreen != m_expandImageToFullScreen;
+
     m_slideInterval = slideInterval;
+    m_showSmallImages = showSmallImages;
     m_expandImageToFullScreen = expandImageToFullScreen;
 
-    findImagesInFolder( path );
-    qDebug() << "Amount of Files:" << m_files.count();
-    QTimer::singleShot( 2000, this, &SlideEffect::slotNewSlide );
+    if ( allScreens != m_allScreens ) {
+        m_allScreens = allScreens;
+        screensChanged();
+    } else if ( rescale ) {
+        // The prepared slides were scaled for the other mode.
+        m_loader->clear();
+    }
+
+    if ( rescan ) {
+        if ( m_indexDirty )
+            m_catalog.save( indexFile(), m_basePath );
+
+        m_loader->clear();
+        m_slideShown = false;
+        m_catalog.clear();
+        m_deck.clear();
+        m_basePath = path;
+        m_searchRecursive = recursive;
+
+        // Start from the catalog of the last run, only the folders which were
+        // modified since then are read again.
+        m_catalog.load( indexFile(), path );
+        m_indexDirty = false;
+
+        // Continue where the last break of this folder stopped, so images are
+        // not repeated before all have been shown.
+        m_catalog.loadShown( deckFile(), path );
+    } else if ( refilter ) {
+        // The catalog holds the small images too, only the deck changes.
+        m_loader->clear();
+        m_deck.clear();
+    }
+
+    if ( rescan || refilter ) {
+        const int minimum = minimumSurface();
+        foreach( quint32 id, m_catalog.images() ) {
+            if ( isLargeEnough( id, minimum ) )
+                m_deck.add( id, m_catalog.isShown( id ) );
+        }
+    }
+    loadImage();
+
+    // The images are found in the background, slides are prepared as soon
+    // as the first ones come in.
+    if ( rescan )
+        m_scanner->start( path, recursive, m_catalog.folders() );
 }
 
 // ------------------ Show widget
 
 
-SlideWidget::SlideWidget( QWidget *parent )
-        : QWidget( parent, Qt::Popup )
+SlideWidget::SlideWidget( int screen, QWidget *parent )
+        : QWidget( parent, Qt::Popup ), m_screen( screen ), m_hasImage( false ),
+          m_shownFrame( -1 ), m_generation( 0 )
 {
     slotDimension();
     connect( QApplication::desktop(), &QDesktopWidget::screenCountChanged, this, &SlideWidget::slotDimension );
+    connect( QApplication::desktop(), &QDesktopWidget::resized, this, &SlideWidget::slotDimension );
 
     QVBoxLayout *boxLayout = new QVBoxLayout( this );
     boxLayout->setSpacing(0);
@@ -213,18 +509,168 @@ SlideWidget::SlideWidget( QWidget *parent )
     m_imageLabel->setMaximumSize( width(), height() );
     m_imageLabel->setAlignment( Qt::AlignCenter );
     layout()->addWidget(m_imageLabel);
+
+    m_fade = new RSITransition( this );
+    connect( m_fade, &RSITransition::frame, this, &SlideWidget::slotFadeFrame );
+    connect( m_fade, &RSITransition::finished, this, &SlideWidget::slotFadeFinished );
+
+    // The frames of a cross-fade are blended in order.
+    m_pool.setMaxThreadCount( 1 );
+
+    m_animation = new SlideAnimation( this );
+    connect( m_animation, &SlideAnimation::frame, this, &SlideWidget::slotAnimationFrame );
 }
 
-SlideWidget::~SlideWidget() {}
+SlideWidget::~SlideWidget()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
 
 void SlideWidget::slotDimension()
 {
-    QRect rect = QApplication::desktop()->screenGeometry(
-                     QApplication::desktop()->primaryScreen() );
+    QRect rect = QApplication::desktop()->screenGeometry( m_screen );
     setGeometry( rect );
 }
 
-void SlideWidget::setImage( const QImage &image )
+void SlideWidget::paintEvent( QPaintEvent *event )
+{
+    QWidget::paintEvent( event );
+    RSIGlobals::instance()->activationTrace()->painted( m_screen );
+}
+
+void SlideWidget::showEvent( QShowEvent *event )
+{
+    QWidget::showEvent( event );
+    if ( !m_animationPath.isEmpty() && !m_fade->isRunning() )
+        m_animation->start( m_animationPath, m_animationSize );
+}
+
+void SlideWidget::hideEvent( QHideEvent *event )
+{
+    // Nobody sees it, do not decode the frames. The next time it is
+    // shown the animation starts over.
+    m_animation->stop();
+    QWidget::hideEvent( event );
+}
+
+void SlideWidget::slotAnimationFrame( const QImage &frame )
+{
+    showImage( frame );
+}
+
+qint64 SlideWidget::imageMemory() const
+{
+    const QPixmap *pixmap = m_imageLabel->pixmap();
+    if ( !pixmap || pixmap->isNull() )
+        return m_animation->memoryUsage();
+    return qint64( pixmap->width() ) * pixmap->height() * pixmap->depth() / 8
+           + m_animation->memoryUsage();
+}
+
+void SlideWidget::release()
+{
+    m_animation->stop();
+    m_animationPath.clear();
+    m_fade->stop();
+    m_generation.ref();
+    m_pool.clear();
+    m_frames.clear();
+    m_next = QImage();
+
+    m_imageLabel->clear();
+    m_hasImage = false;
+    destroy();
+}
+
+// A cross-fade takes half a second.
+static const int crossFadeDuration = 500;
+
+// The frames of one cross-fade may take this much memory, in bytes. Fewer
+// frames are blended for large screens, down to none.
+static const qint64 crossFadeMemory = 64 * 1024 * 1024;
+static const int maximumCrossFadeFrames = 12;
+
+int SlideWidget::crossFadeFrames() const
+{
+    const qint64 frameBytes = qint64( width() ) * height() * 4;
+    if ( frameBytes <= 0 )
+        return 0;
+    return int( qMin( crossFadeMemory / frameBytes, qint64( maximumCrossFadeFrames ) ) );
+}
+
+void SlideWidget::setImage( const QImage &image, const QString &animation )
+{
+    const QPixmap *shown = m_imageLabel->pixmap();
+    const int frames = crossFadeFrames();
+
+    // The frames are scaled like the first one.
+    m_animation->stop();
+    m_animationPath = animation;
+    m_animationSize = image.size();
+
+    // A cross-fade which is still running is cut short.
+    m_fade->stop();
+    m_generation.ref();
+    m_pool.clear();
+    m_frames.clear();
+    m_next = QImage();
+
+    if ( !isVisible() || !m_hasImage || !shown || shown->isNull() || frames == 0 ) {
+        showImage( image );
+        if ( isVisible() && !m_animationPath.isEmpty() )
+            m_animation->start( m_animationPath, m_animationSize );
+        return;
+    }
+
+    m_next = image;
+    m_frames.resize( frames );
+    m_shownFrame = -1;
+    m_pool.start( new BlendJob( this, &m_generation, m_generation.load(), shown->toImage(), image,
+                                size(), palette().color( QPalette::Window ), frames ) );
+    m_fade->start( crossFadeDuration );
+}
+
+void SlideWidget::showImage( const QImage &image )
 {
     m_imageLabel->setPixmap( QPixmap::fromImage(image) );
+    m_hasImage = true;
+}
+
+void SlideWidget::slotBlended( int generation, int index, const QImage &frame, qint64 blendTime )
+{
+    if ( generation != m_generation.load() || index >= m_frames.count() )
+        return;
+
+    m_frames[ index ] = frame;
+    RSIGlobals::instance()->frameStats()->recordBlend( blendTime );
+}
+
+void SlideWidget::slotFadeFrame( qreal progress )
+{
+    // Show the latest frame which is due and ready, the frames which are
+    // not blended in time are skipped.
+    const int due = qMin( int( progress * ( m_frames.count() + 1 ) ) - 1, m_frames.count() - 1 );
+    for ( int i = due; i > m_shownFrame; --i ) {
+        if ( m_frames.at( i ).isNull() )
+            continue;
+
+        showImage( m_frames.at( i ) );
+        m_imageLabel->repaint();
+        for ( int j = m_shownFrame + 1; j <= i; ++j )
+            m_frames[ j ] = QImage();
+        m_shownFrame = i;
+        break;
+    }
+}
+
+void SlideWidget::slotFadeFinished()
+{
+    m_generation.ref();
+    m_frames.clear();
+    showImage( m_next );
+    m_next = QImage();
+
+    if ( isVisible() && !m_animationPath.isEmpty() )
+        m_animation->start( m_animationPath, m_animationSize );
 }
@@ -21,10 +21,19 @@
 #ifndef SLIDESHOW_H
 #define SLIDESHOW_H
 
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QVector>
 #include <QWidget>
 #include "breakbase.h"
+#include "slidecatalog.h"
+#include "slidedeck.h"
 
+class SlideLoader;
+class SlideScanner;
+class SlideAnimation;
 class SlideWidget;
+class RSITransition;
 class QLabel;
 
 class SlideEffect : public BreakBase
@@ -34,20 +43,48 @@ class SlideEffect : public BreakBase
 public:
     SlideEffect( QObject *parent );
     ~SlideEffect();
-    void reset( const QString& path, bool recursive, bool showSmallImages, bool expandImageToFullScreen, int interval );
+    void reset( const QString& path, bool recursive, bool showSmallImages, bool expandImageToFullScreen, int interval,
+                bool allScreens = false );
     void activate() override;
     void deactivate() override;
     bool hasImages();
     void loadImage();
+    void reportMemory( QMap<QString, qint64> &report ) const override;
+    void prepare() override;
+    void retire() override;
+
+protected:
+    void releaseResources() override;
+    void screensChanged() override;
 
 private slots:
     void slotGray();
     void slotNewSlide();
+    void slotSlideReady( int screen );
+    void slotRejected( const QString& name );
+    void slotFolderScanned( const QString& folder, const QStringList& images,
+                            const QList<QSize>& sizes, qint64 modified );
+    void slotFolderRemoved( const QString& folder );
+    void slotScanFinished();
 
 private:
-    void findImagesInFolder( const QString& folder );
-
-    SlideWidget*    m_slidewidget;
+    static QString deckFile();
+    static QString indexFile();
+    bool isLargeEnough( quint32 id, int minimumSurface ) const;
+    int minimumSurface() const;
+    void showSlide( int index );
+    static void showWidget( SlideWidget *widget );
+    QString nextImage();
+
+    // One for every screen showing slides, the loader uses the same index.
+    QVector<SlideWidget*> m_slidewidgets;
+    SlideLoader*    m_loader;
+    SlideScanner*   m_scanner;
+    bool            m_slideShown;
+    bool            m_active;
+    bool            m_grayAllScreens;
+    bool            m_allScreens;
+    bool            m_indexDirty;
     QString         m_basePath;
     QTimer*         m_timer_slide;
 
@@ -56,8 +93,8 @@ private:
     bool            m_expandImageToFullScreen;
     int             m_slideInterval;
 
-    QStringList     m_files;
-    QStringList     m_files_done;
+    SlideCatalog    m_catalog;
+    SlideDeck       m_deck;
 };
 
 class SlideWidget : public QWidget
@@ -66,23 +103,68 @@ class SlideWidget : public QWidget
 public:
     /**
      * Constructor
+     * @param screen The screen to cover
      * @param parent Parent Widget
-     * @param name Name
      */
-    explicit SlideWidget( QWidget *parent = 0 );
+    explicit SlideWidget( int screen, QWidget *parent = 0 );
 
     /**
      * Destructor
      */
     ~SlideWidget();
 
-    void setImage( const QImage &image );
+    /**
+     * Shows @p image. While the widget is shown it cross-fades from the
+     * last image, the frames in between are blended on a worker. When an
+     * @p animation is given, that image is played after the cross-fade
+     * while the widget is shown, @p image is its first frame.
+     */
+    void setImage( const QImage &image, const QString &animation = QString() );
+    bool hasImage() const {
+        return m_hasImage;
+    }
+
+    /** @returns the memory taken by the image and the animation, in bytes. */
+    qint64 imageMemory() const;
+
+    /** Drops the image and destroys the window while hidden. */
+    void release();
+    int screen() const {
+        return m_screen;
+    }
+
+protected:
+    void paintEvent( QPaintEvent *event ) override;
+    void showEvent( QShowEvent *event ) override;
+    void hideEvent( QHideEvent *event ) override;
 
 private slots:
     void slotDimension();
+    void slotAnimationFrame( const QImage &frame );
+    void slotBlended( int generation, int index, const QImage &frame, qint64 blendTime );
+    void slotFadeFrame( qreal progress );
+    void slotFadeFinished();
 
 private:
+    void showImage( const QImage &image );
+    int crossFadeFrames() const;
+
     QLabel *m_imageLabel;
+    int m_screen;
+    bool m_hasImage;
+
+    // The cross-fade to m_next, with the frames which were blended so far.
+    RSITransition *m_fade;
+    QThreadPool m_pool;
+    QImage m_next;
+    QVector<QImage> m_frames;
+    int m_shownFrame;
+    QAtomicInt m_generation;
+
+    // Played while shown, once the cross-fade is done.
+    SlideAnimation *m_animation;
+    QString m_animationPath;
+    QSize m_animationSize;
 
 };
 
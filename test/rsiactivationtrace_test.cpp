@@ -0,0 +1,116 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsiactivationtrace_test.h"
+
+#include <QApplication>
+#include <QDesktopWidget>
+
+#include "grayeffect.h"
+#include "rsiactivationtrace.h"
+#include "rsiglobals.h"
+
+void RSIActivationTraceTest::stages()
+{
+    RSIActivationTrace trace;
+    trace.breakEmitted();
+    QTest::qSleep( 2 );
+    trace.begin( 2 );
+    trace.mark( RSIActivationTrace::Activated );
+
+    trace.painted( 0 );
+    trace.painted( 0 );
+    trace.painted( 5 );
+    QVERIFY( !trace.isComplete() );
+    QCOMPARE( trace.elapsed( RSIActivationTrace::Painted ), qint64( -1 ) );
+    QVERIFY( trace.paintElapsed( 1 ) == -1 );
+
+    trace.painted( 1 );
+    QVERIFY( trace.isComplete() );
+    QCOMPARE( trace.latencies().count(), quint64( 1 ) );
+
+    // The stages follow each other.
+    QCOMPARE( trace.elapsed( RSIActivationTrace::Emitted ), qint64( 0 ) );
+    QVERIFY( trace.elapsed( RSIActivationTrace::Delivered ) >= 2000 );
+    QVERIFY( trace.elapsed( RSIActivationTrace::Activated ) >= trace.elapsed( RSIActivationTrace::Delivered ) );
+    QVERIFY( trace.paintElapsed( 0 ) >= trace.elapsed( RSIActivationTrace::Activated ) );
+    QVERIFY( trace.paintElapsed( 1 ) >= trace.paintElapsed( 0 ) );
+    QVERIFY( trace.elapsed( RSIActivationTrace::Painted ) >= trace.paintElapsed( 1 ) );
+
+    // Paints after the break was shown do not count.
+    trace.painted( 1 );
+    QCOMPARE( trace.latencies().count(), quint64( 1 ) );
+
+    const QVariantMap report = trace.report();
+    QCOMPARE( report.value( "screens" ).toList().count(), 2 );
+    QCOMPARE( report.value( "count" ).toULongLong(), quint64( 1 ) );
+}
+
+void RSIActivationTraceTest::notEmitted()
+{
+    // A break which was not started by the timer starts when it is delivered.
+    RSIActivationTrace trace;
+    trace.begin( 1 );
+    QCOMPARE( trace.elapsed( RSIActivationTrace::Delivered ), qint64( 0 ) );
+    QVERIFY( trace.elapsed( RSIActivationTrace::Activated ) == -1 );
+}
+
+void RSIActivationTraceTest::withoutWindows()
+{
+    // The popup completes the break on every screen at once.
+    RSIActivationTrace trace;
+    trace.begin( 2 );
+    trace.painted( 0 );
+    trace.shownWithoutWindows();
+    QVERIFY( trace.isComplete() );
+    QCOMPARE( trace.latencies().count(), quint64( 1 ) );
+    QVERIFY( trace.paintElapsed( 1 ) >= trace.paintElapsed( 0 ) );
+
+    // Nothing is recorded outside a break.
+    trace.shownWithoutWindows();
+    QCOMPARE( trace.latencies().count(), quint64( 1 ) );
+}
+
+void RSIActivationTraceTest::activationBenchmark()
+{
+    // Only runs when the budget for the 90th percentile is set in
+    // milliseconds with RSIBREAK_ACTIVATION_BUDGET. Use a real X server,
+    // like Xvfb, for meaningful numbers.
+    bool ok = false;
+    const int budget = qgetenv( "RSIBREAK_ACTIVATION_BUDGET" ).toInt( &ok );
+    if ( !ok )
+        QSKIP( "Set RSIBREAK_ACTIVATION_BUDGET to run the activation benchmark" );
+
+    RSIActivationTrace *trace = RSIGlobals::instance()->activationTrace();
+    const quint64 before = trace->latencies().count();
+
+    GrayEffect effect( 0 );
+    QBENCHMARK {
+        trace->breakEmitted();
+        trace->begin( QApplication::desktop()->screenCount() );
+        effect.activate();
+        trace->mark( RSIActivationTrace::Activated );
+        QTRY_VERIFY( trace->isComplete() );
+        effect.deactivate();
+    }
+
+    QVERIFY( trace->latencies().count() > before );
+    qDebug() << "Activation latency p90:" << trace->latencies().percentile( 90 ) << "ms";
+    QVERIFY2( trace->latencies().percentile( 90 ) <= budget,
+              qPrintable( QString( "p90 above the budget of %1 ms" ).arg( budget ) ) );
+}
+
+#include "rsiactivationtrace_test.moc"
@@ -0,0 +1,80 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsiactivitytimeline_test.h"
+
+#include "rsiactivitytimeline.h"
+
+void RSIActivityTimelineTest::runsPerStateChange()
+{
+    RSIActivityTimeline timeline;
+    for ( int i = 0; i < 100; ++i )
+        timeline.append( true );
+    QCOMPARE( timeline.runCount(), 1 );
+
+    for ( int i = 0; i < 50; ++i )
+        timeline.append( false );
+    QCOMPARE( timeline.runCount(), 1 );
+
+    timeline.append( true, 25 );
+    QCOMPARE( timeline.runCount(), 2 );
+    QCOMPARE( timeline.length(), qint64( 175 ) );
+    QCOMPARE( timeline.activeSeconds( 0, timeline.length() ), qint64( 125 ) );
+
+    timeline.reset();
+    QCOMPARE( timeline.runCount(), 0 );
+    QCOMPARE( timeline.length(), qint64( 0 ) );
+}
+
+void RSIActivityTimelineTest::windows()
+{
+    // Compare every window against a plain per second record.
+    RSIActivityTimeline timeline;
+    QVector<bool> seconds;
+    for ( int i = 0; i < 2000; ++i ) {
+        const bool active = ( i % 7 ) < 3 || ( i / 300 ) % 2;
+        timeline.append( active );
+        seconds.append( active );
+    }
+
+    for ( int from = 0; from < seconds.count(); from += 37 ) {
+        for ( int to = from; to <= seconds.count(); to += 53 ) {
+            qint64 expected = 0;
+            for ( int i = from; i < to; ++i )
+                expected += seconds.at( i );
+            QCOMPARE( timeline.activeSeconds( from, to ), expected );
+        }
+    }
+
+    QCOMPARE( timeline.activeSecondsInLast( 1 ), qint64( seconds.last() ) );
+    QCOMPARE( timeline.activeSeconds( -100, 0 ), qint64( 0 ) );
+    QCOMPARE( timeline.activeSeconds( 1990, 5000 ), timeline.activeSecondsInLast( 10 ) );
+}
+
+void RSIActivityTimelineTest::horizon()
+{
+    RSIActivityTimeline timeline( 100 );
+
+    // Alternate every second, so every active second is a run.
+    for ( int i = 0; i < 10000; ++i )
+        timeline.append( i % 2 );
+
+    QVERIFY( timeline.runCount() <= 100 );
+    QCOMPARE( timeline.activeSecondsInLast( 100 ), qint64( 50 ) );
+    QCOMPARE( timeline.activeSecondsInLast( 3 ), qint64( 2 ) );
+}
+
+#include "rsiactivitytimeline_test.moc"
@@ -0,0 +1,47 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsidbuscall_test.h"
+
+#include <QDBusConnection>
+
+#include "rsidbuscall.h"
+
+void RSIDBusCallTest::initTestCase()
+{
+    if ( !QDBusConnection::sessionBus().isConnected() )
+        QSKIP( "No session bus" );
+}
+
+void RSIDBusCallTest::unknownService()
+{
+    RSIDBusCall call( "org.rsibreak.test.missing", "/missing", "org.rsibreak.test.missing", "Missing" );
+
+    // The call returns before the bus replied.
+    call.call( QVariantList() << true );
+    QCOMPARE( call.calls(), quint64( 1 ) );
+    QCOMPARE( call.pending(), 1 );
+
+    QTRY_COMPARE( call.pending(), 0 );
+    QCOMPARE( call.errors(), quint64( 1 ) );
+    QCOMPARE( call.timeouts(), quint64( 0 ) );
+    QCOMPARE( call.latencies().count(), quint64( 0 ) );
+
+    const QVariantMap report = call.report();
+    QVERIFY( report.value( "lastError" ).toString().startsWith( "org.freedesktop.DBus.Error.ServiceUnknown" ) );
+}
+
+#include "rsidbuscall_test.moc"
@@ -0,0 +1,81 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsihistogram_test.h"
+
+#include "rsihistogram.h"
+
+void RSIHistogramTest::bucketBounds()
+{
+    // Every value falls in a bucket which ends at or after it, and after
+    // the end of the previous bucket.
+    for ( int v = 0; v < 100000; ++v ) {
+        const int index = RSIHistogram::bucketIndex( v );
+        QVERIFY( index >= 0 && index < RSIHistogram::BucketCount );
+        QVERIFY( RSIHistogram::bucketUpperBound( index ) >= v );
+        if ( index > 0 )
+            QVERIFY( RSIHistogram::bucketUpperBound( index - 1 ) < v );
+    }
+
+    QCOMPARE( RSIHistogram::bucketIndex( INT_MAX ), RSIHistogram::BucketCount - 1 );
+    QCOMPARE( RSIHistogram::bucketUpperBound( RSIHistogram::BucketCount - 1 ), INT_MAX );
+    QCOMPARE( RSIHistogram::bucketIndex( -5 ), 0 );
+}
+
+void RSIHistogramTest::exactSmallValues()
+{
+    RSIHistogram histogram;
+    QCOMPARE( histogram.percentile( 50 ), 0 );
+
+    for ( int v = 1; v <= 10; ++v )
+        histogram.record( v );
+
+    QCOMPARE( histogram.count(), quint64( 10 ) );
+    QCOMPARE( histogram.percentile( 50 ), 5 );
+    QCOMPARE( histogram.percentile( 90 ), 9 );
+    QCOMPARE( histogram.percentile( 100 ), 10 );
+}
+
+void RSIHistogramTest::percentiles()
+{
+    RSIHistogram histogram;
+    for ( int v = 1; v <= 10000; ++v )
+        histogram.record( v );
+
+    // Within the precision of a bucket, which is 1/8th.
+    const int p50 = histogram.percentile( 50 );
+    const int p99 = histogram.percentile( 99 );
+    QVERIFY2( p50 >= 5000 && p50 <= 5000 * 9 / 8, QByteArray::number( p50 ) );
+    QVERIFY2( p99 >= 9900 && p99 <= 9900 * 9 / 8, QByteArray::number( p99 ) );
+}
+
+void RSIHistogramTest::merge()
+{
+    RSIHistogram a;
+    RSIHistogram b;
+    RSIHistogram all;
+    for ( int v = 0; v < 500; ++v ) {
+        ( v % 2 ? a : b ).record( v * 7 );
+        all.record( v * 7 );
+    }
+
+    RSIHistogram merged = RSIHistogram::fromCounts( a.counts() );
+    merged.merge( b );
+    QVERIFY( merged == all );
+    QCOMPARE( merged.count(), quint64( 500 ) );
+}
+
+#include "rsihistogram_test.moc"
@@ -0,0 +1,94 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsinotifier_test.h"
+
+#include <QTemporaryDir>
+
+#include "rsinotifier.h"
+
+void RSINotifierTest::hooks()
+{
+    QTemporaryDir dir;
+    const QString log = dir.path() + "/hooks";
+    const QString command = "echo $RSIBREAK_EVENT-$RSIBREAK_BREAK >> " + log;
+
+    RSINotifier notifier;
+    notifier.setNotificationsEnabled( false );
+    notifier.setCommands( command, command );
+    QSignalSpy finished( &notifier, SIGNAL( hookFinished( QString, int ) ) );
+
+    // Nothing runs before the event loop gets to it.
+    notifier.notifyBreak( true, true );
+    notifier.notifyBreak( false, false );
+    QCOMPARE( notifier.running(), 0 );
+    QCOMPARE( notifier.queued(), 0 );
+
+    QTRY_COMPARE( finished.count(), 2 );
+    QCOMPARE( finished.at( 0 ).at( 1 ).toInt(), 0 );
+
+    QFile file( log );
+    QVERIFY( file.open( QIODevice::ReadOnly ) );
+    QStringList lines = QString::fromLatin1( file.readAll() ).split( '\n', QString::SkipEmptyParts );
+    lines.sort();
+    QCOMPARE( lines, QStringList() << "end-short" << "start-long" );
+
+    QCOMPARE( notifier.report().value( "started" ).toULongLong(), quint64( 2 ) );
+    QCOMPARE( notifier.report().value( "failed" ).toULongLong(), quint64( 0 ) );
+}
+
+void RSINotifierTest::timeout()
+{
+    RSINotifier notifier;
+    notifier.setNotificationsEnabled( false );
+    notifier.setLimits( 1, 100 );
+    notifier.setCommands( "sleep 10", "exit 3" );
+    QSignalSpy finished( &notifier, SIGNAL( hookFinished( QString, int ) ) );
+
+    notifier.notifyBreak( true, false );
+    QTRY_COMPARE( finished.count(), 1 );
+    QCOMPARE( finished.at( 0 ).at( 1 ).toInt(), -1 );
+    QCOMPARE( notifier.report().value( "timeouts" ).toULongLong(), quint64( 1 ) );
+
+    notifier.notifyBreak( false, false );
+    QTRY_COMPARE( finished.count(), 2 );
+    QCOMPARE( finished.at( 1 ).at( 1 ).toInt(), 3 );
+    QCOMPARE( notifier.report().value( "failed" ).toULongLong(), quint64( 1 ) );
+}
+
+void RSINotifierTest::bounded()
+{
+    RSINotifier notifier;
+    notifier.setNotificationsEnabled( false );
+    notifier.setLimits( 1, 5000 );
+    notifier.setCommands( "sleep 0.2", QString() );
+    QSignalSpy finished( &notifier, SIGNAL( hookFinished( QString, int ) ) );
+
+    for ( int i = 0; i < 3; ++i )
+        notifier.notifyBreak( true, false );
+    QTRY_COMPARE( notifier.running() + notifier.queued(), 3 );
+    QCOMPARE( notifier.running(), 1 );
+
+    QTRY_COMPARE( finished.count(), 3 );
+    QCOMPARE( notifier.running(), 0 );
+
+    // Without a command only the notification is sent.
+    notifier.notifyBreak( false, false );
+    QTest::qWait( 50 );
+    QCOMPARE( notifier.report().value( "started" ).toULongLong(), quint64( 3 ) );
+}
+
+#include "rsinotifier_test.moc"
@@ -0,0 +1,142 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsistats_test.h"
+
+#include "rsistats.h"
+#include "rsistatsmodel.h"
+
+#include <math.h>
+
+void RSIStatsTest::snapshotOnPublish()
+{
+    RSIStats *stats = RSIGlobals::instance()->stats();
+    stats->reset();
+
+    std::shared_ptr<const RSIStatsSnapshot> before = stats->snapshot();
+
+    // Changes are invisible to readers till the writer publishes them.
+    stats->increaseStat( TINY_BREAKS_SKIPPED );
+    stats->increaseStat( TINY_BREAKS );
+    QCOMPARE( stats->getStat( TINY_BREAKS_SKIPPED ).toInt(), 0 );
+    QCOMPARE( stats->getStat( TINY_BREAKS ).toInt(), 0 );
+
+    stats->publish();
+    QCOMPARE( stats->getStat( TINY_BREAKS_SKIPPED ).toInt(), 1 );
+    QCOMPARE( stats->getStat( TINY_BREAKS ).toInt(), 1 );
+
+    // A reader still holding the old snapshot keeps a consistent view.
+    QCOMPARE( before->value( TINY_BREAKS_SKIPPED ).toInt(), 0 );
+    QCOMPARE( before->value( TINY_BREAKS ).toInt(), 0 );
+}
+
+void RSIStatsTest::resetPublishes()
+{
+    RSIStats *stats = RSIGlobals::instance()->stats();
+    stats->increaseStat( BIG_BREAKS_POSTPONED );
+    stats->publish();
+    QCOMPARE( stats->getStat( BIG_BREAKS_POSTPONED ).toInt(), 1 );
+
+    stats->reset();
+    QCOMPARE( stats->getStat( BIG_BREAKS_POSTPONED ).toInt(), 0 );
+}
+
+void RSIStatsTest::modelRefresh()
+{
+    RSIStats *stats = RSIGlobals::instance()->stats();
+    stats->reset();
+
+    RSIStatsModel *model = stats->model();
+    model->refresh();
+    QCOMPARE( model->rowCount(), static_cast<int>( STAT_COUNT ) );
+    QCOMPARE( model->data( model->statIndex( BIG_BREAKS_SKIPPED ) ).toString(), QString( "0" ) );
+
+    QSignalSpy spy( model, SIGNAL( dataChanged( QModelIndex, QModelIndex, QVector<int> ) ) );
+
+    // Nothing published, nothing changed.
+    model->refresh();
+    QCOMPARE( spy.count(), 0 );
+
+    stats->increaseStat( BIG_BREAKS_SKIPPED, 3 );
+    stats->publish();
+    model->refresh();
+    QCOMPARE( spy.count(), 1 );
+    const QModelIndex changed = spy.takeFirst().at( 0 ).value<QModelIndex>();
+    QCOMPARE( changed.row(), static_cast<int>( BIG_BREAKS_SKIPPED ) );
+    QCOMPARE( model->data( model->statIndex( BIG_BREAKS_SKIPPED ) ).toString(), QString( "3" ) );
+    QCOMPARE( model->data( model->statIndex( BIG_BREAKS_SKIPPED ), RSIStatsModel::ValueRole ).toInt(), 3 );
+}
+
+void RSIStatsTest::idlePeriodsAndWorkStreaks()
+{
+    RSIStats *stats = RSIGlobals::instance()->stats();
+    stats->reset();
+
+    const int threshold = RSIGlobals::instance()->intervals()[TINY_BREAK_THRESHOLD];
+
+    // Three streaks of 101 seconds, with short pauses of 5 seconds in them,
+    // separated by rests.
+    for ( int streak = 0; streak < 3; ++streak ) {
+        for ( int i = 0; i < 100; ++i ) {
+            const int idle = ( i % 20 ) < 15 ? 0 : ( i % 20 ) - 14;
+            stats->setStat( CURRENT_IDLE_TIME, idle );
+        }
+        stats->setStat( CURRENT_IDLE_TIME, 0 );
+        for ( int i = 1; i <= threshold; ++i )
+            stats->setStat( CURRENT_IDLE_TIME, i );
+    }
+    stats->publish();
+
+    std::shared_ptr<const RSIStatsSnapshot> snapshot = stats->snapshot();
+    QCOMPARE( snapshot->workStreaks().count(), quint64( 3 ) );
+    QCOMPARE( stats->getStat( WORK_STREAK_P50 ).toInt(), RSIHistogram::bucketUpperBound( RSIHistogram::bucketIndex( 101 ) ) );
+
+    // Per streak five pauses of 5 seconds, plus the rests. The last rest
+    // did not end yet, so it is not counted.
+    QCOMPARE( snapshot->idlePeriods().count(), quint64( 3 * 5 + 2 ) );
+    QCOMPARE( stats->getStat( IDLE_PERIOD_P50 ).toInt(), 5 );
+}
+
+void RSIStatsTest::activityAverages()
+{
+    RSIStats *stats = RSIGlobals::instance()->stats();
+    stats->reset();
+
+    // After an hour of activity the hourly average covers 1 - 1/e of it.
+    for ( int i = 0; i < 3600; ++i )
+        stats->increaseStat( ACTIVITY );
+    stats->publish();
+
+    QVERIFY( qAbs( stats->getStat( ACTIVITY_EWMA_HOUR ).toDouble() - 100.0 * ( 1.0 - exp( -1.0 ) ) ) < 0.01 );
+    QVERIFY( stats->getStat( ACTIVITY_EWMA_DAY ).toDouble() < stats->getStat( ACTIVITY_EWMA_HOUR ).toDouble() );
+    QVERIFY( stats->getStat( ACTIVITY_EWMA_WEEK ).toDouble() < stats->getStat( ACTIVITY_EWMA_DAY ).toDouble() );
+
+    // Idle seconds one by one decay the same as a gap at once.
+    for ( int i = 1; i <= 600; ++i )
+        stats->setStat( MAX_IDLENESS, i, true );
+    stats->publish();
+    const double ticked = stats->getStat( ACTIVITY_EWMA_HOUR ).toDouble();
+
+    stats->reset();
+    for ( int i = 0; i < 3600; ++i )
+        stats->increaseStat( ACTIVITY );
+    stats->addIdleGap( 600 );
+    stats->publish();
+
+    QVERIFY( qAbs( stats->getStat( ACTIVITY_EWMA_HOUR ).toDouble() - ticked ) < 1e-6 );
+}
+
+#include "rsistats_test.moc"
@@ -0,0 +1,61 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsistatus_test.h"
+
+#include <QDBusMetaType>
+
+#include "rsistatus.h"
+
+void RSIStatusTest::visibleChanges()
+{
+    RSIStatus shown;
+    shown.tinyLeft = 600;
+    shown.bigLeft = 3000;
+    shown.icon = "rsibreak0";
+
+    // Within the same minute nothing changes, neither does the idle time.
+    RSIStatus status = shown;
+    status.tinyLeft = 590;
+    status.bigLeft = 2990;
+    status.idleTime = 5;
+    QVERIFY( !status.differsVisiblyFrom( shown ) );
+
+    status.tinyLeft = 540;
+    QVERIFY( status.differsVisiblyFrom( shown ) );
+
+    // The last minute counts down in seconds.
+    shown.tinyLeft = 60;
+    status = shown;
+    status.tinyLeft = 59;
+    QVERIFY( status.differsVisiblyFrom( shown ) );
+
+    status = shown;
+    status.breakLeft = 20;
+    QVERIFY( status.differsVisiblyFrom( shown ) );
+
+    status = shown;
+    status.icon = "rsibreakx";
+    QVERIFY( status.differsVisiblyFrom( shown ) );
+}
+
+void RSIStatusTest::signature()
+{
+    const int type = qDBusRegisterMetaType<RSIStatus>();
+    QCOMPARE( QString::fromLatin1( QDBusMetaType::typeToSignature( type ) ), QString( "(iiiibbss)" ) );
+}
+
+#include "rsistatus_test.moc"
@@ -0,0 +1,90 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsistatusserver_test.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QTemporaryDir>
+
+#include "rsistatusserver.h"
+
+static QJsonObject readLine( QLocalSocket &socket )
+{
+    if ( !socket.canReadLine() )
+        return QJsonObject();
+    return QJsonDocument::fromJson( socket.readLine() ).object();
+}
+
+void RSIStatusServerTest::stream()
+{
+    QTemporaryDir dir;
+    RSIStatusServer server;
+    QVERIFY( server.listen( dir.path() + "/status" ) );
+
+    RSIStatus status;
+    status.tinyLeft = 600;
+    status.icon = "rsibreak0";
+    server.publish( status );
+
+    // The current status comes right after connecting.
+    QLocalSocket socket;
+    socket.connectToServer( server.path() );
+    QVERIFY( socket.waitForConnected( 1000 ) );
+    QTRY_VERIFY( socket.canReadLine() );
+    QJsonObject line = readLine( socket );
+    QCOMPARE( line.value( "tinyLeft" ).toInt(), 600 );
+    QCOMPARE( line.value( "icon" ).toString(), QString( "rsibreak0" ) );
+    QCOMPARE( server.clients(), 1 );
+
+    status.breakLeft = 20;
+    status.inBreak = true;
+    server.publish( status );
+    QTRY_VERIFY( socket.canReadLine() );
+    line = readLine( socket );
+    QCOMPARE( line.value( "breakLeft" ).toInt(), 20 );
+    QCOMPARE( line.value( "inBreak" ).toBool(), true );
+
+    socket.disconnectFromServer();
+    QTRY_COMPARE( server.clients(), 0 );
+    QCOMPARE( server.dropped(), quint64( 0 ) );
+}
+
+void RSIStatusServerTest::slowClient()
+{
+    QTemporaryDir dir;
+    RSIStatusServer server;
+    QVERIFY( server.listen( dir.path() + "/status" ) );
+
+    QLocalSocket socket;
+    socket.connectToServer( server.path() );
+    QVERIFY( socket.waitForConnected( 1000 ) );
+    QTRY_COMPARE( server.clients(), 1 );
+
+    // Without the event loop nothing gets written, so the lines pile up.
+    server.setMaxBuffered( 256 );
+    RSIStatus status;
+    for ( int i = 0; i < 10; ++i ) {
+        status.tinyLeft = i;
+        server.publish( status );
+    }
+    QCOMPARE( server.clients(), 0 );
+    QCOMPARE( server.dropped(), quint64( 1 ) );
+    QTRY_COMPARE( socket.state(), QLocalSocket::UnconnectedState );
+}
+
+#include "rsistatusserver_test.moc"
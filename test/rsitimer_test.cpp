@@ -17,6 +17,7 @@
 #include "rsitimer_test.h"
 
 #include "rsitimer.h"
+#include "rsibreakpreparation.h"
 
 static constexpr int RELAX_ENDED_MAGIC_VALUE = -1;
 
@@ -376,4 +377,58 @@ void RSITimerTest::regularBreaks()
     // RSITimer owns idleTime, so not deleting it.
 }
 
+void RSITimerTest::idleSkipReleasesPreparation()
+{
+    RSIIdleTimeFake* idleTime = new RSIIdleTimeFake();
+    RSITimer timer( idleTime, m_intervals, true, true );
+
+    // Wired up like RSIObject does.
+    const int prepareSeconds = 2 * m_intervals[TINY_BREAK_THRESHOLD];
+    RSIBreakPreparation preparation;
+    preparation.setPrepareSeconds( prepareSeconds );
+    QList<RSIBreakPreparation::Action> actions;
+    connect( &timer, &RSITimer::updateToolTip, [&]( int tinyLeft, int bigLeft ) {
+        const RSIBreakPreparation::Action action = preparation.update( tinyLeft, bigLeft );
+        if ( action != RSIBreakPreparation::Nothing )
+            actions << action;
+    } );
+    connect( &timer, &RSITimer::relax, [&]( int breakLeft, bool ) {
+        if ( breakLeft > 0 )
+            preparation.breakStarted();
+    } );
+
+    // Part one, working till shortly before the tiny break.
+    int ticks = m_intervals[TINY_BREAK_INTERVAL] - prepareSeconds + 10;
+    idleTime->setIdleTime( 0 );
+    for ( int i = 0; i < ticks; i++ ) {
+        timer.timeout();
+    }
+    QCOMPARE( actions, QList<RSIBreakPreparation::Action>() << RSIBreakPreparation::Prepare );
+    QVERIFY( preparation.isPrepared() );
+
+    // Part two, idle long enough to skip the break, the effect is released.
+    for ( int i = 0; i < m_intervals[TINY_BREAK_THRESHOLD]; i++ ) {
+        QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+        idleTime->setIdleTime( ( i + 1 ) * 1000 );
+        timer.timeout();
+    }
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+    QCOMPARE( actions.count(), 2 );
+    QCOMPARE( actions.at( 1 ), RSIBreakPreparation::Release );
+    QVERIFY( !preparation.isPrepared() );
+
+    // Part three, the next break is prepared again and kept when it starts.
+    idleTime->setIdleTime( 0 );
+    for ( int i = 0; i < m_intervals[TINY_BREAK_INTERVAL]; i++ ) {
+        QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+        timer.timeout();
+    }
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Suggesting );
+    QCOMPARE( actions.count(), 3 );
+    QCOMPARE( actions.at( 2 ), RSIBreakPreparation::Prepare );
+    QVERIFY( preparation.isPrepared() );
+
+    // RSITimer owns idleTime, so not deleting it.
+}
+
 #include "rsitimer_test.moc"
@@ -37,6 +37,7 @@ private slots:
     void skipBreak();
     void noPopupBreak();
     void regularBreaks();
+    void idleSkipReleasesPreparation();
 };
 
 #endif //RSIBREAK_RSITIMER_TEST_H
@@ -0,0 +1,124 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "rsitransition_test.h"
+
+#include "breakbase.h"
+#include "rsiframestats.h"
+#include "rsiglobals.h"
+#include "rsitransition.h"
+
+void RSITransitionTest::frameStats()
+{
+    RSIFrameStats stats;
+    QCOMPARE( stats.cpuShare(), 0.0 );
+
+    stats.recordFrame( 1000, 0 );
+    stats.recordFrame( 3000, 2 );
+    stats.recordBlend( 6000 );
+    stats.recordTransition( 100000 );
+
+    QCOMPARE( stats.frames(), quint64( 2 ) );
+    QCOMPARE( stats.droppedFrames(), quint64( 2 ) );
+    QCOMPARE( stats.transitions(), quint64( 1 ) );
+    QCOMPARE( stats.cpuShare(), 10.0 );
+
+    const QVariantMap report = stats.report();
+    QCOMPARE( report.value( "frames" ).toULongLong(), quint64( 2 ) );
+    QVERIFY( report.value( "p99" ).toInt() >= 3000 );
+
+    stats.reset();
+    QCOMPARE( stats.frames(), quint64( 0 ) );
+    QCOMPARE( stats.cpuShare(), 0.0 );
+}
+
+void RSITransitionTest::progress()
+{
+    RSIFrameStats stats;
+    RSITransition transition;
+    transition.setStats( &stats );
+
+    QList<qreal> frames;
+    connect( &transition, &RSITransition::frame, [&frames]( qreal progress ) {
+        frames << progress;
+    } );
+    QSignalSpy finished( &transition, SIGNAL(finished()) );
+
+    transition.start( 100 );
+    // The first frame is drawn right away.
+    QCOMPARE( frames.count(), 1 );
+    QVERIFY( transition.isRunning() );
+
+    QTRY_COMPARE( finished.count(), 1 );
+    QVERIFY( !transition.isRunning() );
+    QCOMPARE( frames.last(), qreal( 1 ) );
+    for ( int i = 1; i < frames.count(); ++i )
+        QVERIFY( frames.at( i ) >= frames.at( i - 1 ) );
+
+    QCOMPARE( stats.frames(), quint64( frames.count() ) );
+    QCOMPARE( stats.transitions(), quint64( 1 ) );
+}
+
+void RSITransitionTest::stop()
+{
+    RSIFrameStats stats;
+    RSITransition transition;
+    transition.setStats( &stats );
+    QSignalSpy finished( &transition, SIGNAL(finished()) );
+
+    transition.start( 1000 );
+    transition.stop();
+    QVERIFY( !transition.isRunning() );
+    QTest::qWait( 50 );
+    QCOMPARE( finished.count(), 0 );
+    QCOMPARE( stats.transitions(), quint64( 1 ) );
+
+    // Without a duration the last frame comes right away.
+    transition.start( 0 );
+    QCOMPARE( finished.count(), 1 );
+}
+
+void RSITransitionTest::fadeBenchmark()
+{
+    // Only runs when the CPU share the fades may take is set in percent
+    // with RSIBREAK_FRAME_CPU_BUDGET. Use a software rendered X server,
+    // like Xvfb, for meaningful numbers.
+    bool ok = false;
+    const int budget = qgetenv( "RSIBREAK_FRAME_CPU_BUDGET" ).toInt( &ok );
+    if ( !ok )
+        QSKIP( "Set RSIBREAK_FRAME_CPU_BUDGET to run the fade benchmark" );
+
+    RSIFrameStats *stats = RSIGlobals::instance()->frameStats();
+    stats->reset();
+
+    GrayWidget widget;
+    widget.setLevel( 80 );
+    QBENCHMARK {
+        widget.fadeIn();
+        QTest::qWait( 300 );
+        widget.fadeOut();
+        QTRY_VERIFY( !widget.isVisible() );
+    }
+
+    QVERIFY( stats->frames() > 0 );
+    qDebug() << "Fade frames" << stats->frames() << "dropped" << stats->droppedFrames()
+             << "p90" << stats->frameTimes().percentile( 90 ) << "us, CPU share"
+             << stats->cpuShare() << "%";
+    QVERIFY2( stats->cpuShare() <= budget,
+              qPrintable( QString( "CPU share above the budget of %1%" ).arg( budget ) ) );
+}
+
+#include "rsitransition_test.moc"
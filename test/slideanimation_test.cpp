@@ -0,0 +1,99 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slideanimation_test.h"
+
+#include <QTemporaryDir>
+
+#include "slideanimation.h"
+#include "slideloader.h"
+
+// A 2x2 GIF with 3 frames of 50 ms, which loops forever.
+static const char animatedGif[] =
+    "\x47\x49\x46\x38\x39\x61\x02\x00\x02\x00\x80\x00\x00\x00\x00\x00\xff\xff\xff\x21\xff\x0b\x4e\x45\x54\x53\x43\x41\x50\x45\x32\x2e\x30\x03\x01\x00\x00\x00\x21\xf9"
+    "\x04\x00\x05\x00\x00\x00\x2c\x00\x00\x00\x00\x02\x00\x02\x00\x00\x02\x04\x04\x41\x10\x05\x00\x21\xf9\x04\x00\x05\x00\x00\x00\x2c\x00\x00\x00\x00\x02\x00\x02\x00"
+    "\x00\x02\x04\x0c\xc3\x30\x05\x00\x21\xf9\x04\x00\x05\x00\x00\x00\x2c\x00\x00\x00\x00\x02\x00\x02\x00\x00\x02\x04\x04\xc3\x10\x05\x00\x3b";
+
+static QString createAnimation( const QTemporaryDir &dir )
+{
+    const QString path = dir.path() + "/animated.gif";
+    QFile file( path );
+    file.open( QIODevice::WriteOnly );
+    file.write( animatedGif, sizeof( animatedGif ) - 1 );
+    return path;
+}
+
+void SlideAnimationTest::isAnimated()
+{
+    QTemporaryDir dir;
+    QVERIFY( SlideAnimation::isAnimated( createAnimation( dir ) ) );
+
+    QImage image( 10, 10, QImage::Format_RGB32 );
+    image.fill( Qt::darkGreen );
+    const QString still = dir.path() + "/still.png";
+    image.save( still, "PNG" );
+    QVERIFY( !SlideAnimation::isAnimated( still ) );
+
+    // The loader tells while decoding the first frame.
+    bool animated = false;
+    QVERIFY( !SlideLoader::decode( createAnimation( dir ), QSize( 4, 4 ), Qt::KeepAspectRatio, 0,
+                                   0, &animated ).isNull() );
+    QVERIFY( animated );
+    QVERIFY( !SlideLoader::decode( still, QSize( 4, 4 ), Qt::KeepAspectRatio, 0, 0, &animated ).isNull() );
+    QVERIFY( !animated );
+}
+
+void SlideAnimationTest::play()
+{
+    QTemporaryDir dir;
+    const QString path = createAnimation( dir );
+
+    SlideAnimation animation;
+    QSignalSpy frames( &animation, SIGNAL( frame( QImage ) ) );
+    animation.start( path, QSize( 4, 4 ) );
+    QVERIFY( animation.isRunning() );
+
+    // It loops, so it shows more frames than the image has.
+    QTRY_VERIFY( frames.count() >= 5 );
+    QCOMPARE( frames.first().first().value<QImage>().size(), QSize( 4, 4 ) );
+
+    // Only a few frames are decoded ahead.
+    QVERIFY( animation.memoryUsage() <= 8 * 4 * 4 * 4 );
+
+    animation.stop();
+    QVERIFY( !animation.isRunning() );
+    QCOMPARE( animation.memoryUsage(), qint64( 0 ) );
+    const int shown = frames.count();
+    QTest::qWait( 200 );
+    QCOMPARE( frames.count(), shown );
+}
+
+void SlideAnimationTest::restart()
+{
+    QTemporaryDir dir;
+    const QString path = createAnimation( dir );
+
+    // Starting again drops the frames of the last run.
+    SlideAnimation animation;
+    QSignalSpy frames( &animation, SIGNAL( frame( QImage ) ) );
+    animation.start( path, QSize( 4, 4 ) );
+    animation.start( path, QSize( 8, 8 ) );
+    QTRY_VERIFY( frames.count() >= 2 );
+    foreach( const QList<QVariant> &frame, frames )
+        QCOMPARE( frame.first().value<QImage>().size(), QSize( 8, 8 ) );
+}
+
+#include "slideanimation_test.moc"
@@ -0,0 +1,96 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slidecache_test.h"
+
+#include <QTemporaryDir>
+
+#include "slidecache.h"
+
+static QImage slide( int width )
+{
+    QImage image( width, 100, QImage::Format_RGB32 );
+    image.fill( Qt::darkBlue );
+    return image;
+}
+
+void SlideCacheTest::findInserted()
+{
+    QTemporaryDir dir;
+    SlideCache cache( dir.path() );
+
+    const QDateTime modified = QDateTime::currentDateTime();
+    const SlideCache::Target target = { QSize( 200, 100 ), Qt::KeepAspectRatio, 0 };
+
+    QVERIFY( cache.find( "/a.jpg", modified, target ).isNull() );
+    cache.insert( "/a.jpg", modified, target, slide( 200 ) );
+    QCOMPARE( cache.find( "/a.jpg", modified, target ).size(), QSize( 200, 100 ) );
+    QVERIFY( cache.size() > 0 );
+
+    // A changed original, or another target, is not found.
+    QVERIFY( cache.find( "/a.jpg", modified.addSecs( 1 ), target ).isNull() );
+    const SlideCache::Target expanded = { QSize( 200, 100 ), Qt::KeepAspectRatioByExpanding, 0 };
+    QVERIFY( cache.find( "/a.jpg", modified, expanded ).isNull() );
+    QVERIFY( cache.find( "/b.jpg", modified, target ).isNull() );
+}
+
+void SlideCacheTest::leastRecentlyUsed()
+{
+    QTemporaryDir dir;
+    const QDateTime modified = QDateTime::currentDateTime();
+    const SlideCache::Target target = { QSize( 200, 100 ), Qt::KeepAspectRatio, 0 };
+
+    // Find out how large a single entry is.
+    qint64 entrySize;
+    {
+        QTemporaryDir measure;
+        SlideCache cache( measure.path() );
+        cache.insert( "/a.jpg", modified, target, slide( 200 ) );
+        entrySize = cache.size();
+    }
+
+    SlideCache cache( dir.path(), entrySize * 2 );
+    cache.insert( "/a.jpg", modified, target, slide( 200 ) );
+    cache.insert( "/b.jpg", modified, target, slide( 200 ) );
+    QVERIFY( !cache.find( "/a.jpg", modified, target ).isNull() );
+
+    // b was used longest ago, so it makes place for c.
+    cache.insert( "/c.jpg", modified, target, slide( 200 ) );
+    QVERIFY( cache.size() <= entrySize * 2 );
+    QVERIFY( cache.find( "/b.jpg", modified, target ).isNull() );
+    QVERIFY( !cache.find( "/a.jpg", modified, target ).isNull() );
+    QVERIFY( !cache.find( "/c.jpg", modified, target ).isNull() );
+}
+
+void SlideCacheTest::persistent()
+{
+    QTemporaryDir dir;
+    const QDateTime modified = QDateTime::currentDateTime();
+    const SlideCache::Target target = { QSize( 200, 100 ), Qt::KeepAspectRatio, 0 };
+
+    qint64 size;
+    {
+        SlideCache cache( dir.path() );
+        cache.insert( "/a.jpg", modified, target, slide( 200 ) );
+        size = cache.size();
+    }
+
+    SlideCache cache( dir.path() );
+    QCOMPARE( cache.size(), size );
+    QCOMPARE( cache.find( "/a.jpg", modified, target ).size(), QSize( 200, 100 ) );
+}
+
+#include "slidecache_test.moc"
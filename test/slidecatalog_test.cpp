@@ -0,0 +1,185 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slidecatalog_test.h"
+
+#include <QTemporaryDir>
+
+#include "slidecatalog.h"
+
+static QStringList images( const QString &folder, int from, int to )
+{
+    QStringList result;
+    for ( int i = from; i < to; ++i )
+        result.append( folder + QString( "/image%1.jpg" ).arg( i ) );
+    return result;
+}
+
+void SlideCatalogTest::pathsAndSizes()
+{
+    SlideCatalog catalog;
+    QVector<quint32> added, removed;
+    const QStringList list = QStringList() << "/images/one.jpg" << QString::fromUtf8( "/images/tr\xc3\xa9s.png" );
+    catalog.setFolder( "/images", 0, list, QList<QSize>() << QSize( 1920, 1080 ) << QSize(),
+                       &added, &removed );
+
+    QCOMPARE( catalog.count(), 2 );
+    QCOMPARE( added.count(), 2 );
+    QVERIFY( removed.isEmpty() );
+    QCOMPARE( catalog.path( added.at( 0 ) ), list.at( 0 ) );
+    QCOMPARE( catalog.path( added.at( 1 ) ), list.at( 1 ) );
+    QCOMPARE( catalog.size( added.at( 0 ) ), QSize( 1920, 1080 ) );
+    QVERIFY( !catalog.size( added.at( 1 ) ).isValid() );
+    QCOMPARE( catalog.find( list.at( 1 ) ), added.at( 1 ) );
+    QCOMPARE( catalog.find( "/images/two.jpg" ), SlideCatalog::NoImage );
+    QCOMPARE( catalog.find( "/other/one.jpg" ), SlideCatalog::NoImage );
+}
+
+void SlideCatalogTest::rescanKeepsIds()
+{
+    SlideCatalog catalog;
+    QVector<quint32> added, removed;
+    catalog.setFolder( "/images", 0, images( "/images", 0, 10 ), QList<QSize>(), &added, &removed );
+    const quint32 kept = catalog.find( "/images/image5.jpg" );
+    const quint32 gone = catalog.find( "/images/image0.jpg" );
+
+    added.clear();
+    catalog.setFolder( "/images", 0, images( "/images", 1, 11 ), QList<QSize>(), &added, &removed );
+    QCOMPARE( catalog.count(), 10 );
+    QCOMPARE( removed, QVector<quint32>() << gone );
+    QCOMPARE( added.count(), 1 );
+    QCOMPARE( catalog.find( "/images/image5.jpg" ), kept );
+
+    // The ID of the removed image is used again.
+    QCOMPARE( added.first(), gone );
+    QCOMPARE( catalog.path( gone ), QString( "/images/image10.jpg" ) );
+}
+
+void SlideCatalogTest::removeFolder()
+{
+    SlideCatalog catalog;
+    QVector<quint32> added, removed;
+    catalog.setFolder( "/images", 0, images( "/images", 0, 3 ), QList<QSize>(), &added, &removed );
+    catalog.setFolder( "/images/sub", 0, images( "/images/sub", 0, 4 ), QList<QSize>(), &added, &removed );
+    catalog.setFolder( "/images2", 0, images( "/images2", 0, 5 ), QList<QSize>(), &added, &removed );
+
+    catalog.removeFolder( "/images", &removed );
+    QCOMPARE( removed.count(), 7 );
+    QCOMPARE( catalog.count(), 5 );
+    foreach( quint32 id, removed )
+        QVERIFY( !catalog.contains( id ) );
+
+    catalog.remove( catalog.find( "/images2/image0.jpg" ) );
+    QCOMPARE( catalog.count(), 4 );
+    QCOMPARE( catalog.find( "/images2/image0.jpg" ), SlideCatalog::NoImage );
+}
+
+void SlideCatalogTest::compactNames()
+{
+    SlideCatalog catalog;
+    QVector<quint32> added, removed;
+    catalog.setFolder( "/images", 0, images( "/images", 0, 2000 ), QList<QSize>(), &added, &removed );
+    const qint64 full = catalog.memoryUsage();
+
+    // Removing most images frees the space of their names.
+    catalog.setFolder( "/images", 0, images( "/images", 1900, 2000 ), QList<QSize>(), &added, &removed );
+    QCOMPARE( catalog.count(), 100 );
+    QVERIFY( catalog.memoryUsage() < full );
+    for ( int i = 1900; i < 2000; ++i ) {
+        const QString path = QString( "/images/image%1.jpg" ).arg( i );
+        QCOMPARE( catalog.path( catalog.find( path ) ), path );
+    }
+}
+
+void SlideCatalogTest::saveAndLoadShown()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.path() + "/shown";
+
+    SlideCatalog catalog;
+    QVector<quint32> added, removed;
+    catalog.setFolder( "/images", 0, images( "/images", 0, 20 ), QList<QSize>(), &added, &removed );
+    for ( int i = 0; i < 15; ++i )
+        catalog.setShown( added.at( i ), true );
+    QVERIFY( catalog.saveShown( fileName, "/images" ) );
+
+    // Another folder does not continue the round.
+    SlideCatalog other;
+    QVERIFY( !other.loadShown( fileName, "/other" ) );
+
+    // Images are added after loading, like they come in from the scan.
+    SlideCatalog loaded;
+    QVERIFY( loaded.loadShown( fileName, "/images" ) );
+    added.clear();
+    loaded.setFolder( "/images", 0, images( "/images", 0, 20 ), QList<QSize>(), &added, &removed );
+    int shown = 0;
+    foreach( quint32 id, added ) {
+        if ( loaded.isShown( id ) )
+            ++shown;
+    }
+    QCOMPARE( shown, 15 );
+
+    loaded.clearShown();
+    QVERIFY( !loaded.isShown( added.first() ) );
+}
+
+void SlideCatalogTest::saveAndLoad()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.path() + "/index";
+
+    SlideCatalog catalog;
+    QVector<quint32> added, removed;
+    catalog.setFolder( "/images", 1000, images( "/images", 0, 3 ),
+                       QList<QSize>() << QSize( 640, 480 ) << QSize() << QSize( 10, 20 ),
+                       &added, &removed );
+    catalog.setFolder( "/images/sub", 2000, images( "/images/sub", 0, 2 ), QList<QSize>(),
+                       &added, &removed );
+    catalog.setFolder( "/images/empty", 3000, QStringList(), QList<QSize>(), &added, &removed );
+    catalog.setFolder( "/images/gone", 4000, images( "/images/gone", 0, 2 ), QList<QSize>(),
+                       &added, &removed );
+    catalog.removeFolder( "/images/gone", &removed );
+    QVERIFY( catalog.save( fileName, "/images" ) );
+
+    SlideCatalog other;
+    QVERIFY( !other.load( fileName, "/other" ) );
+
+    SlideCatalog loaded;
+    QVERIFY( loaded.load( fileName, "/images" ) );
+    QCOMPARE( loaded.count(), 5 );
+
+    QHash<QString, qint64> folders;
+    folders.insert( "/images", 1000 );
+    folders.insert( "/images/sub", 2000 );
+    folders.insert( "/images/empty", 3000 );
+    QCOMPARE( loaded.folders(), folders );
+
+    QStringList paths;
+    foreach( quint32 id, loaded.images() )
+        paths.append( loaded.path( id ) );
+    paths.sort();
+    QCOMPARE( paths, QStringList() << images( "/images", 0, 3 ) << images( "/images/sub", 0, 2 ) );
+    QCOMPARE( loaded.size( loaded.find( "/images/image0.jpg" ) ), QSize( 640, 480 ) );
+    QVERIFY( !loaded.size( loaded.find( "/images/image1.jpg" ) ).isValid() );
+
+    // A truncated index is not used.
+    QFile file( fileName );
+    QVERIFY( file.resize( file.size() - 3 ) );
+    QVERIFY( !loaded.load( fileName, "/images" ) );
+    QCOMPARE( loaded.count(), 0 );
+}
+
+#include "slidecatalog_test.moc"
@@ -0,0 +1,89 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slidedeck_test.h"
+
+#include "slidedeck.h"
+
+static SlideDeck *createDeck( int count )
+{
+    SlideDeck *deck = new SlideDeck;
+    for ( int i = 0; i < count; ++i )
+        deck->add( i );
+    return deck;
+}
+
+void SlideDeckTest::noRepeatsInRound()
+{
+    QScopedPointer<SlideDeck> deck( createDeck( 100 ) );
+
+    for ( int round = 0; round < 3; ++round ) {
+        QSet<quint32> seen;
+        for ( int i = 0; i < 100; ++i )
+            seen.insert( deck->next() );
+        QCOMPARE( seen.count(), 100 );
+        QCOMPARE( deck->shownCount(), 100 );
+    }
+}
+
+void SlideDeckTest::addAndRemove()
+{
+    QScopedPointer<SlideDeck> deck( createDeck( 10 ) );
+
+    QSet<quint32> seen;
+    for ( int i = 0; i < 5; ++i )
+        seen.insert( deck->next() );
+
+    // Remove a card which was shown, and one which was not.
+    const quint32 shown = *seen.begin();
+    seen.remove( shown );
+    deck->remove( shown );
+    quint32 hidden = 0;
+    while ( seen.contains( hidden ) || hidden == shown )
+        ++hidden;
+    deck->remove( hidden );
+    QVERIFY( !deck->contains( hidden ) );
+    deck->add( 1000 );
+    deck->add( 1000 );
+
+    QCOMPARE( deck->count(), 9 );
+    QCOMPARE( deck->shownCount(), 4 );
+
+    // The rest of the round brings the cards which were not shown yet.
+    QSet<quint32> rest;
+    for ( int i = 0; i < 5; ++i )
+        rest.insert( deck->next() );
+    QCOMPARE( rest.count(), 5 );
+    QVERIFY( rest.contains( 1000 ) );
+    QVERIFY( !rest.contains( hidden ) );
+    QVERIFY( !rest.contains( shown ) );
+    QVERIFY( !rest.intersects( seen ) );
+}
+
+void SlideDeckTest::addShown()
+{
+    QScopedPointer<SlideDeck> deck( createDeck( 10 ) );
+    deck->add( 10, true );
+    deck->add( 11, true );
+    QCOMPARE( deck->shownCount(), 2 );
+    QVERIFY( deck->isShown( 10 ) );
+    QVERIFY( !deck->isShown( 0 ) );
+
+    for ( int i = 0; i < 10; ++i )
+        QVERIFY( deck->next() < 10 );
+}
+
+#include "slidedeck_test.moc"
@@ -0,0 +1,170 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slideloader_test.h"
+
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+#include "slideloader.h"
+
+static QString createImage( const QTemporaryDir &dir, const QString &name, const QSize &size )
+{
+    QImage image( size, QImage::Format_RGB32 );
+    image.fill( Qt::darkGreen );
+
+    const QString path = dir.path() + '/' + name;
+    image.save( path, "PNG" );
+    return path;
+}
+
+void SlideLoaderTest::initTestCase()
+{
+    // Keep the slide cache away from the one of the user.
+    QStandardPaths::setTestModeEnabled( true );
+}
+
+void SlideLoaderTest::decode()
+{
+    QTemporaryDir dir;
+    const QString path = createImage( dir, "wide.png", QSize( 400, 200 ) );
+
+    QImage image = SlideLoader::decode( path, QSize( 200, 200 ), Qt::KeepAspectRatio, 0 );
+    QCOMPARE( image.size(), QSize( 200, 100 ) );
+
+    image = SlideLoader::decode( path, QSize( 200, 200 ), Qt::KeepAspectRatioByExpanding, 0 );
+    QCOMPARE( image.size(), QSize( 400, 200 ) );
+
+    // Too small, or not an image at all.
+    QVERIFY( SlideLoader::decode( path, QSize( 200, 200 ), Qt::KeepAspectRatio, 400 * 200 + 1 ).isNull() );
+    QVERIFY( SlideLoader::decode( dir.path() + "/missing.png", QSize( 200, 200 ), Qt::KeepAspectRatio, 0 ).isNull() );
+}
+
+void SlideLoaderTest::prefetch()
+{
+    QTemporaryDir dir;
+    const QString big = createImage( dir, "big.png", QSize( 300, 300 ) );
+    const QString small = createImage( dir, "small.png", QSize( 10, 10 ) );
+
+    SlideLoader loader;
+    loader.setTarget( QSize( 100, 100 ), Qt::KeepAspectRatio, 1000 );
+
+    QSignalSpy ready( &loader, SIGNAL( slideReady( int ) ) );
+    QSignalSpy rejected( &loader, SIGNAL( rejected( QString ) ) );
+
+    loader.prepare( big );
+    loader.prepare( small );
+    QCOMPARE( loader.pending(), 2 );
+
+    QTRY_COMPARE( ready.count() + rejected.count(), 2 );
+    QCOMPARE( rejected.count(), 1 );
+    QCOMPARE( rejected.first().first().toString(), small );
+
+    QCOMPARE( loader.pending(), 1 );
+    QVERIFY( loader.hasSlide() );
+    QCOMPARE( loader.takeSlide().size(), QSize( 100, 100 ) );
+    QCOMPARE( loader.pending(), 0 );
+
+    // Results for an old target are dropped.
+    loader.prepare( big );
+    loader.setTarget( QSize( 50, 50 ), Qt::KeepAspectRatio, 0 );
+    QCOMPARE( loader.pending(), 0 );
+    QTest::qWait( 200 );
+    QVERIFY( !loader.hasSlide() );
+}
+
+void SlideLoaderTest::screens()
+{
+    QTemporaryDir dir;
+    const QString path = createImage( dir, "big.png", QSize( 400, 400 ) );
+
+    SlideLoader loader;
+    loader.setTarget( QSize( 100, 100 ), Qt::KeepAspectRatio, 0, 0 );
+    loader.setTarget( QSize( 200, 200 ), Qt::KeepAspectRatio, 0, 1 );
+
+    QSignalSpy ready( &loader, SIGNAL( slideReady( int ) ) );
+    loader.prepare( path, 0 );
+    loader.prepare( path, 1 );
+    QCOMPARE( loader.pending( 0 ), 1 );
+    QCOMPARE( loader.pending( 1 ), 1 );
+
+    QTRY_COMPARE( ready.count(), 2 );
+    QCOMPARE( loader.takeSlide( 1 ).size(), QSize( 200, 200 ) );
+    QCOMPARE( loader.takeSlide( 0 ).size(), QSize( 100, 100 ) );
+
+    // Changing the target of one screen leaves the other alone.
+    loader.prepare( path, 0 );
+    loader.prepare( path, 1 );
+    loader.setTarget( QSize( 50, 50 ), Qt::KeepAspectRatio, 0, 1 );
+    QCOMPARE( loader.pending( 0 ), 1 );
+    QCOMPARE( loader.pending( 1 ), 0 );
+    QTRY_VERIFY( loader.hasSlide( 0 ) );
+}
+
+void SlideLoaderTest::decodeBenchmark_data()
+{
+    QTest::addColumn<bool>( "reduced" );
+    QTest::addColumn<int>( "mode" );
+
+    QTest::newRow( "full size, keep aspect" ) << false << int( Qt::KeepAspectRatio );
+    QTest::newRow( "reduced, keep aspect" ) << true << int( Qt::KeepAspectRatio );
+    QTest::newRow( "full size, expand" ) << false << int( Qt::KeepAspectRatioByExpanding );
+    QTest::newRow( "reduced, expand" ) << true << int( Qt::KeepAspectRatioByExpanding );
+}
+
+void SlideLoaderTest::decodeBenchmark()
+{
+    QFETCH( bool, reduced );
+    QFETCH( int, mode );
+
+    static QTemporaryDir dir;
+    const QString path = dir.path() + "/photo.jpg";
+    if ( !QFile::exists( path ) ) {
+        QImage photo( 4000, 3000, QImage::Format_RGB32 );
+        for ( int y = 0; y < photo.height(); ++y ) {
+            QRgb *line = reinterpret_cast<QRgb *>( photo.scanLine( y ) );
+            for ( int x = 0; x < photo.width(); ++x )
+                line[ x ] = qRgb( x % 256, y % 256, ( x + y ) % 256 );
+        }
+        QVERIFY( photo.save( path, "JPG", 90 ) );
+    }
+
+    const QSize screen( 1920, 1080 );
+    const Qt::AspectRatioMode aspect = static_cast<Qt::AspectRatioMode>( mode );
+
+    // The image buffers which are alive at the same time, not counting the
+    // buffers of the decoder itself, so this is not the peak memory of the
+    // process. Decoding at reduced size only needs the slide.
+    qint64 buffers = 0;
+    QImage slide;
+    QBENCHMARK {
+        if ( reduced ) {
+            slide = SlideLoader::decode( path, screen, aspect, 0 );
+            buffers = slide.byteCount();
+        } else {
+            // How slides were loaded before: decode at full size, then scale
+            // into a second image.
+            QImage image( path );
+            slide = image.scaled( screen, aspect );
+            buffers = qint64( image.byteCount() ) + slide.byteCount();
+        }
+    }
+
+    qDebug() << "Decoded buffer size:" << buffers / 1024 << "KiB";
+    QCOMPARE( slide.size(), QSize( 4000, 3000 ).scaled( screen, aspect ) );
+}
+
+#include "slideloader_test.moc"
@@ -0,0 +1,134 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "slidescanner_test.h"
+
+#include <QTemporaryDir>
+
+#include "slidescanner.h"
+
+static void touch( const QString &path )
+{
+    QFile file( path );
+    file.open( QIODevice::WriteOnly );
+}
+
+void SlideScannerTest::recursive()
+{
+    QTemporaryDir dir;
+    QDir( dir.path() ).mkpath( "a/b" );
+    touch( dir.path() + "/1.jpg" );
+    touch( dir.path() + "/notes.txt" );
+    touch( dir.path() + "/a/2.PNG" );
+    touch( dir.path() + "/a/b/3.gif" );
+
+    QImage image( 30, 20, QImage::Format_RGB32 );
+    image.fill( Qt::black );
+    image.save( dir.path() + "/0.png", "PNG" );
+
+    SlideScanner scanner;
+    QSignalSpy scanned( &scanner, SIGNAL( folderScanned( QString, QStringList, QList<QSize>, qint64 ) ) );
+    QSignalSpy finished( &scanner, SIGNAL( finished() ) );
+
+    scanner.start( dir.path(), true );
+    QVERIFY( scanner.isScanning() );
+    QTRY_COMPARE( finished.count(), 1 );
+    QVERIFY( !scanner.isScanning() );
+
+    QStringList images;
+    for ( int i = 0; i < scanned.count(); ++i )
+        images += scanned.at( i ).at( 1 ).toStringList();
+    images.sort();
+
+    QCOMPARE( scanned.count(), 3 );
+    QCOMPARE( images, QStringList() << dir.path() + "/0.png"
+                                    << dir.path() + "/1.jpg"
+                                    << dir.path() + "/a/2.PNG"
+                                    << dir.path() + "/a/b/3.gif" );
+
+    // Without recursion only the folder itself is read. The size of an
+    // image is known, an empty file has none.
+    scanned.clear();
+    scanner.start( dir.path(), false );
+    QTRY_COMPARE( finished.count(), 2 );
+    QCOMPARE( scanned.count(), 1 );
+    QCOMPARE( scanned.first().at( 1 ).toStringList(), QStringList() << dir.path() + "/0.png"
+                                                                  << dir.path() + "/1.jpg" );
+    const QList<QSize> sizes = scanned.first().at( 2 ).value< QList<QSize> >();
+    QCOMPARE( sizes.count(), 2 );
+    QCOMPARE( sizes.at( 0 ), QSize( 30, 20 ) );
+    QVERIFY( !sizes.at( 1 ).isValid() );
+}
+
+void SlideScannerTest::changes()
+{
+    QTemporaryDir dir;
+    QDir( dir.path() ).mkpath( "a" );
+    touch( dir.path() + "/a/1.jpg" );
+
+    SlideScanner scanner;
+    QSignalSpy scanned( &scanner, SIGNAL( folderScanned( QString, QStringList, QList<QSize>, qint64 ) ) );
+    QSignalSpy removed( &scanner, SIGNAL( folderRemoved( QString ) ) );
+    QSignalSpy finished( &scanner, SIGNAL( finished() ) );
+
+    scanner.start( dir.path(), true );
+    QTRY_COMPARE( finished.count(), 1 );
+    scanned.clear();
+
+    // Only the changed folder is read again.
+    touch( dir.path() + "/a/2.jpg" );
+    QTRY_VERIFY_WITH_TIMEOUT( scanned.count() >= 1, 10000 );
+    QCOMPARE( scanned.last().at( 0 ).toString(), dir.path() + "/a" );
+    QCOMPARE( scanned.last().at( 1 ).toStringList().count(), 2 );
+
+    QVERIFY( QDir( dir.path() + "/a" ).removeRecursively() );
+    QTRY_VERIFY_WITH_TIMEOUT( removed.count() >= 1, 10000 );
+    QCOMPARE( removed.first().at( 0 ).toString(), dir.path() + "/a" );
+}
+
+void SlideScannerTest::knownFolders()
+{
+    QTemporaryDir dir;
+    QDir( dir.path() ).mkpath( "a/b" );
+    touch( dir.path() + "/1.jpg" );
+    touch( dir.path() + "/a/2.jpg" );
+
+    SlideScanner scanner;
+    QSignalSpy scanned( &scanner, SIGNAL( folderScanned( QString, QStringList, QList<QSize>, qint64 ) ) );
+    QSignalSpy removed( &scanner, SIGNAL( folderRemoved( QString ) ) );
+    QSignalSpy finished( &scanner, SIGNAL( finished() ) );
+
+    scanner.start( dir.path(), true );
+    QTRY_COMPARE( finished.count(), 1 );
+    QHash<QString, qint64> known;
+    for ( int i = 0; i < scanned.count(); ++i )
+        known.insert( scanned.at( i ).at( 0 ).toString(), scanned.at( i ).at( 3 ).toLongLong() );
+    QCOMPARE( known.count(), 3 );
+
+    // Folders which did not change are not read again, the ones which are
+    // gone are reported.
+    known.insert( dir.path() + "/gone", 1 );
+    known.insert( dir.path() + "/a", 0 );
+    scanned.clear();
+    scanner.start( dir.path(), true, known );
+    QTRY_COMPARE( finished.count(), 2 );
+    QCOMPARE( scanned.count(), 1 );
+    QCOMPARE( scanned.first().at( 0 ).toString(), dir.path() + "/a" );
+    QCOMPARE( removed.count(), 1 );
+    QCOMPARE( removed.first().at( 0 ).toString(), dir.path() + "/gone" );
+}
+
+#include "slidescanner_test.moc"
@@ -19,6 +19,21 @@
 
 #include "rsitimer_test.h"
 #include "rsitimercounter_test.h"
+#include "rsistats_test.h"
+#include "rsihistogram_test.h"
+#include "rsiactivitytimeline_test.h"
+#include "rsiactivationtrace_test.h"
+#include "rsitransition_test.h"
+#include "rsidbuscall_test.h"
+#include "rsinotifier_test.h"
+#include "rsistatus_test.h"
+#include "rsistatusserver_test.h"
+#include "slideloader_test.h"
+#include "slideanimation_test.h"
+#include "slidecache_test.h"
+#include "slidescanner_test.h"
+#include "slidedeck_test.h"
+#include "slidecatalog_test.h"
 
 int main( int argc, char *argv[] )
 {
@@ -27,6 +42,21 @@ int main( int argc, char *argv[] )
     std::vector<std::unique_ptr<QObject>> tests;
     tests.emplace_back( new RSITimerCounterTest() );
     tests.emplace_back( new RSITimerTest() );
+    tests.emplace_back( new RSIStatsTest() );
+    tests.emplace_back( new RSIHistogramTest() );
+    tests.emplace_back( new RSIActivityTimelineTest() );
+    tests.emplace_back( new RSIActivationTraceTest() );
+    tests.emplace_back( new RSITransitionTest() );
+    tests.emplace_back( new RSIDBusCallTest() );
+    tests.emplace_back( new RSINotifierTest() );
+    tests.emplace_back( new RSIStatusTest() );
+    tests.emplace_back( new RSIStatusServerTest() );
+    tests.emplace_back( new SlideLoaderTest() );
+    tests.emplace_back( new SlideAnimationTest() );
+    tests.emplace_back( new SlideCacheTest() );
+    tests.emplace_back( new SlideScannerTest() );
+    tests.emplace_back( new SlideDeckTest() );
+    tests.emplace_back( new SlideCatalogTest() );
 
     int status = 0;
     for ( auto& test : tests ) {